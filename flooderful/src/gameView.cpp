@@ -6,7 +6,6 @@
 
 struct gameView : lsAppView
 {
-  game *pGame;
   vec2f lookAtPos;
   float_t lookAtRotation;
   float_t lookAtDistance;
@@ -49,8 +48,7 @@ lsResult gameView_init(_Out_ lsAppView **ppView, lsAppState *pAppState)
   *ppView = pView;
 
   LS_ERROR_CHECK(game_init());
-
-  pView->pGame = game_getGame();
+  LS_ERROR_CHECK(game_startSimulationThread()); // From here on the game is only accessed through snapshots.
 
 epilogue:
   if (LS_FAILED(result))
@@ -71,54 +69,58 @@ lsResult gameView_update(lsAppView *pSelf, lsAppView **ppNext, lsAppState *pAppS
 
   render_startFrame(pAppState);
 
-  LS_ERROR_CHECK(game_tick());
+  const game_snapshot *pSnapshot = nullptr;
+  LS_ERROR_CHECK(game_acquireSnapshot(&pSnapshot));
 
   if (lsKeyboardState_KeyPress(&pAppState->keyboardState, SDL_SCANCODE_W))
-    game_setPlayerMapIndex(d_topLeft);
+    LS_ERROR_CHECK(game_setPlayerMapIndex(d_topLeft));
   else if (lsKeyboardState_KeyPress(&pAppState->keyboardState, SDL_SCANCODE_E))
-    game_setPlayerMapIndex(d_topRight);
+    LS_ERROR_CHECK(game_setPlayerMapIndex(d_topRight));
   else if (lsKeyboardState_KeyPress(&pAppState->keyboardState, SDL_SCANCODE_A))
-    game_setPlayerMapIndex(d_left);
+    LS_ERROR_CHECK(game_setPlayerMapIndex(d_left));
   else if (lsKeyboardState_KeyPress(&pAppState->keyboardState, SDL_SCANCODE_D))
-    game_setPlayerMapIndex(d_right);
+    LS_ERROR_CHECK(game_setPlayerMapIndex(d_right));
   else if (lsKeyboardState_KeyPress(&pAppState->keyboardState, SDL_SCANCODE_Z))
-    game_setPlayerMapIndex(d_bottomLeft);
+    LS_ERROR_CHECK(game_setPlayerMapIndex(d_bottomLeft));
   else if (lsKeyboardState_KeyPress(&pAppState->keyboardState, SDL_SCANCODE_X))
-    game_setPlayerMapIndex(d_bottomRight);
+    LS_ERROR_CHECK(game_setPlayerMapIndex(d_bottomRight));
 
   if (lsKeyboardState_KeyPress(&pAppState->keyboardState, SDL_SCANCODE_M)) // if more resource types follow, handle this like everything else and just make it shift/alt + num.
-    game_playerSwitchTiles(tT_market);
+    LS_ERROR_CHECK(game_playerSwitchTiles(tT_market));
 
   for (int32_t i = 0; i < 11; i++)
   {
     // resource type 0 - 9
     if (lsKeyboardState_KeyPress(&pAppState->keyboardState, i + SDL_SCANCODE_1))
     {
-      game_playerSwitchTiles((resource_type)i);
+      LS_ERROR_CHECK(game_playerSwitchTiles((resource_type)i));
       break;
     }
     // resource type 10 - 19
     else if (lsKeyboardState_KeyPress(&pAppState->keyboardState, i + SDL_SCANCODE_KP_1))
     {
-      game_playerSwitchTiles((resource_type)(i + 1 + 10)); // + 1 to compensate for tT_market having a seperate key
+      LS_ERROR_CHECK(game_playerSwitchTiles((resource_type)(i + 1 + 10))); // + 1 to compensate for tT_market having a seperate key
       break;
     }
   }
 
   // Draw Scene
+  if (pSnapshot != nullptr) // The simulation didn't tick yet.
   {
-    const float_t ticksSinceOrigin = (pView->pGame->lastPredictTimeNs - pView->pGame->gameStartTimeNs) / (1e9f / pView->pGame->tickRate);
+    const int64_t now = lsGetCurrentTimeNs();
+    const float_t ticksSinceOrigin = (now - (int64_t)pSnapshot->gameStartTimeNs) / (1e9f / pSnapshot->tickRate);
+    const float_t interpolation = game_snapshotInterpolation(*pSnapshot, now);
 
     render_setTicksSinceOrigin(ticksSinceOrigin);
 
     // rendered objects
-    if (pView->pGame->levelInfo.isNight)
-      render_drawMap(pView->pGame->levelInfo, pAppState, pool_get(pView->pGame->movementActors, 0)->target, vec4f(0.6f, 0.6f, 0.8f, 0));
+    if (pSnapshot->isNight)
+      render_drawMap(*pSnapshot, pAppState, vec4f(0.6f, 0.6f, 0.8f, 0));
     else
-      render_drawMap(pView->pGame->levelInfo, pAppState, pool_get(pView->pGame->movementActors, 0)->target, vec4f(1.f, 1.f, 1.f, 0));
+      render_drawMap(*pSnapshot, pAppState, vec4f(1.f, 1.f, 1.f, 0));
 
-    for (const auto &&_actor : pView->pGame->movementActors)
-      render_drawActor(*_actor.pItem, _actor.index);
+    for (const snapshot_actor &actor : pSnapshot->actors)
+      render_drawActor(lsLerp(actor.previousPos, actor.pos, interpolation), actor.index);
 
     render_flushRenderQueue();
   }
@@ -133,5 +135,7 @@ void gameView_destroy(lsAppView **ppSelf, lsAppState *pAppState)
 {
   (void)pAppState;
 
+  game_stopSimulationThread();
+
   lsFreePtr(ppSelf);
 }
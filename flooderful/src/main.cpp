@@ -43,7 +43,7 @@ lsResult MainGameLoop(int32_t argc, const char **pArgs)
 
     lsAppView *pNext = _AppState.pCurrentView;
 
-    // gameView_init sets `pView->pUpdate = gameView_update` which calls `game_tick()`
+    // gameView_init sets `pView->pUpdate = gameView_update`, which forwards the player input and renders the latest snapshot of the simulation thread.
     LS_ERROR_CHECK(_AppState.pCurrentView->pUpdate(_AppState.pCurrentView, &pNext, &_AppState));
 
     if (pNext != nullptr && pNext != _AppState.pCurrentView)
@@ -264,7 +264,7 @@ void render_drawArrow(size_t x, size_t y, direction dir)
 size_t r = 0;
 float_t z = 0;
 
-void render_drawMap(const level_info &levelInfo, lsAppState *pAppState, const pathfinding_target_type debugArrow, const vec4f lightColor)
+void render_drawMap(const game_snapshot &snapshot, lsAppState *pAppState, const vec4f lightColor)
 {
   (void)pAppState;
 
@@ -295,16 +295,16 @@ void render_drawMap(const level_info &levelInfo, lsAppState *pAppState, const pa
 
   static_assert(LS_ARRAYSIZE(colors) == tT_count);
 
-  for (size_t y = 0; y < levelInfo.map_size.y; y++)
+  for (size_t y = 0; y < snapshot.map_size.y; y++)
   {
-    for (size_t x = 0; x < levelInfo.map_size.x; x++)
+    for (size_t x = 0; x < snapshot.map_size.x; x++)
     {
       float_t v = 1.f;
 
       if (y % 2)
         v = 1.55f;
 
-      render_drawHex2D(matrix::Translation(v + x * 1.1f, 2.f + y * 1.6f, 0) * matrix::Scale(60.f, 40.f, 0), colors[levelInfo.pGameplayMap[y * levelInfo.map_size.x + x].tileType] * lightColor + vec4f(0.1f, 0.1f, 0.1f, 0) * levelInfo.pPathfindingMap[y * levelInfo.map_size.x + x].elevationLevel);
+      render_drawHex2D(matrix::Translation(v + x * 1.1f, 2.f + y * 1.6f, 0) * matrix::Scale(60.f, 40.f, 0), colors[snapshot.pTileTypes[y * snapshot.map_size.x + x]] * lightColor + vec4f(0.1f, 0.1f, 0.1f, 0) * snapshot.pElevations[y * snapshot.map_size.x + x]);
     }
   }
 
@@ -315,32 +315,33 @@ void render_drawMap(const level_info &levelInfo, lsAppState *pAppState, const pa
 
     float_t v = 1.f;
 
-    if (levelInfo.playerPos.y % 2)
+    if (snapshot.playerPos.y % 2)
       v = 1.55f;
 
-    render_drawHex2D(matrix::Translation(v + levelInfo.playerPos.x * 1.1f, 2.f + levelInfo.playerPos.y * 1.6f, 0) * matrix::Scale(60.f, 40.f, 0), vec4f(1.f, 1.f, 1.f, 0.25f + 0.25f * (lsSin(lsGetCurrentTimeMs() * (lsTWOPIf / 1000.0f)))));
+    render_drawHex2D(matrix::Translation(v + snapshot.playerPos.x * 1.1f, 2.f + snapshot.playerPos.y * 1.6f, 0) * matrix::Scale(60.f, 40.f, 0), vec4f(1.f, 1.f, 1.f, 0.25f + 0.25f * (lsSin(lsGetCurrentTimeMs() * (lsTWOPIf / 1000.0f)))));
   }
 
   render_setBlendEnabled(false);
 
   // Draw Debug Arrows.
+  if (snapshot.hasDebugDirections) // Not resident or still filling.
   {
-    for (size_t j = 0; j < levelInfo.map_size.x * levelInfo.map_size.y; j++)
+    for (size_t j = 0; j < snapshot.map_size.x * snapshot.map_size.y; j++)
     {
-      const direction dir = (direction)levelInfo.resources[debugArrow].pDirectionLookup[1 - levelInfo.resources[debugArrow].write_direction_idx][j].dir;
+      const direction dir = direction_map_getDir(snapshot.debugDirections, j);
 
       if (dir != d_unreachable && dir < d_atDestination)
-        render_drawArrow(j % levelInfo.map_size.x, j / levelInfo.map_size.x, dir);
+        render_drawArrow(j % snapshot.map_size.x, j / snapshot.map_size.x, dir);
     }
   }
 }
 
-void render_drawActor(const movement_actor actor, size_t index) // In Future: flush all actors being drawed.
+void render_drawActor(const vec2f pos, size_t index) // In Future: flush all actors being drawed.
 {
   vec4f color = vec4f(0.1f + index * 0.2f, 1.f - index * 0.2f, 1.f, 1.f);
 
   const matrix mat = matrix::Translation(-0.5f, -0.5f, 0) * matrix::Scale(-1.f, -1.f, 0) * matrix::Translation(0.5f, 0.5f, 0) * matrix::Scale(30.f, 50.f, 0);
-  render_drawColored2DQuad(mat * matrix::Translation(75.f + actor.pos.x * 66.f, 70.f + actor.pos.y * 65.f, 0), color, rTI_pupu);
+  render_drawColored2DQuad(mat * matrix::Translation(75.f + pos.x * 66.f, 70.f + pos.y * 65.f, 0), color, rTI_pupu);
 }
 
 void render_flushRenderQueue()
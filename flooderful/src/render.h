@@ -30,8 +30,8 @@ void render_drawHex(const matrix &model, const vec4f color);
 void render_drawHex2D(const matrix &model, const vec4f color);
 void render_drawHex3D(const matrix &model, const vec4f color);
 
-void render_drawMap(const level_info &levelInfo, lsAppState *pAppState, const pathfinding_target_type debugArrow, const vec4f lightColor);
-void render_drawActor(const movement_actor actor, size_t index);
+void render_drawMap(const game_snapshot &snapshot, lsAppState *pAppState, const vec4f lightColor);
+void render_drawActor(const vec2f pos, size_t index);
 
 void render_flushRenderQueue();
 
@@ -56,9 +56,7 @@
 #undef NEAR
 #undef FAR
 #else
-#include <x86intrin.h>
-
-#define __debugbreak() __builtin_trap()
+#include "platform_shim.h"
 #endif
 
 #ifndef _In_
@@ -73,6 +71,22 @@
 #define _In_Out_
 #endif
 
+#ifndef _Out_opt_
+#define _Out_opt_
+#endif
+
+#ifndef IN
+#define IN
+#endif
+
+#ifndef OUT
+#define OUT
+#endif
+
+#ifndef OPTIONAL
+#define OPTIONAL
+#endif
+
 #ifdef _MSC_VER
 #define LS_ALIGN(bytes) __declspec(align(bytes))
 #else
@@ -213,6 +227,13 @@ public:
   do { lsErrorPushSilentImpl __silence__##__LINE__##_; LS_ERROR_IF(conditional, resultOnError); } while (0)
 
 
+// `__FUNCTION__` is only a string literal that can be concatenated with MSVC.
+#ifdef _MSC_VER
+#define LS_FUNCTION_PREFIX __FUNCTION__ ": "
+#else
+#define LS_FUNCTION_PREFIX ""
+#endif
+
 #ifdef _DEBUG
 #define lsFail() \
   do \
@@ -223,7 +244,7 @@ public:
 #define lsAssertInternal(a, expression_text) \
   do \
   { if (!(a)) \
-    { const char *__output_text = __FUNCTION__ ": Assertion Failed ('" expression_text "') in File '" __FILE__ "' (Line " LS_STRINGIFY_VALUE(__LINE__) ")"; \
+    { const char *__output_text = LS_FUNCTION_PREFIX "Assertion Failed ('" expression_text "') in File '" __FILE__ "' (Line " LS_STRINGIFY_VALUE(__LINE__) ")"; \
       if (lsPrintErrorCallback == nullptr) puts(__output_text); \
       else lsPrintErrorCallback(__output_text); \
       __debugbreak(); \
@@ -869,8 +890,8 @@ struct vec2t
   inline T LengthSquared() const { return x * x + y * y; };
   inline vec2t<T> Normalize() const { return *this / (T)Length(); };
 
-  inline typename float_t AspectRatio() const { return (float_t)x / (float_t)y; };
-  inline typename float_t InverseAspectRatio() const { return (float_t)y / (float_t)x; };
+  inline float_t AspectRatio() const { return (float_t)x / (float_t)y; };
+  inline float_t InverseAspectRatio() const { return (float_t)y / (float_t)x; };
 
   inline static T Dot(const vec2t<T> a, const vec2t<T> b)
   {
@@ -1471,9 +1492,15 @@ lsResult lsSetOutputFilePath(const char *path, const bool append = true);
 void lsResetOutputFile();
 void lsFlushOutput();
 
+#ifdef _MSC_VER
 #define print(text, ...) lsPrintToFunction(lsPrintCallback, text, __VA_ARGS__)
 #define print_error_line(text, ...) lsPrintToFunction(lsPrintErrorCallback, text, __VA_ARGS__)
 #define print_log_line(text, ...) lsPrintToFunction(lsPrintLogCallback, text, __VA_ARGS__)
+#else // Other preprocessors keep the trailing comma without any arguments.
+#define print(text, ...) lsPrintToFunction(lsPrintCallback, text __VA_OPT__(,) __VA_ARGS__)
+#define print_error_line(text, ...) lsPrintToFunction(lsPrintErrorCallback, text __VA_OPT__(,) __VA_ARGS__)
+#define print_log_line(text, ...) lsPrintToFunction(lsPrintLogCallback, text __VA_OPT__(,) __VA_ARGS__)
+#endif
 
 void print_to_dbgcon(const char *text);
 
@@ -107,16 +107,129 @@ enum direction : uint8_t
 struct pathfinding_info
 {
   direction dir;
-  uint8_t dist;
+  uint32_t dist;
 };
 
+enum tile_storage_layout : uint8_t
+{
+  tSL_rowMajor, // Tiles are stored at their tile index (`y * width + x`).
+  tSL_chunked, // Square chunks of `TileStorageChunkSize` tiles are stored after each other, so the neighbours in the rows above and below mostly share cache lines.
+};
+
+static constexpr size_t TileStorageChunkSize = 8; // 8x8 direction nibbles are half a cache line.
+static_assert((TileStorageChunkSize & (TileStorageChunkSize - 1)) == 0, "Chunk coordinates are split off with shifts and masks.");
+
+// Maps tile indices to the position they're stored at in the per-tile buffers of a direction map.
+struct tile_storage
+{
+  tile_storage_layout layout = tSL_rowMajor;
+  size_t width = 0;
+  size_t chunksPerRow = 0;
+  size_t count = 0; // Number of stored tiles, including the padding of partial chunks.
+};
+
+inline tile_storage tile_storage_create(const tile_storage_layout layout, const size_t width, const size_t height)
+{
+  tile_storage storage;
+  storage.layout = layout;
+  storage.width = width;
+  storage.chunksPerRow = (width + TileStorageChunkSize - 1) / TileStorageChunkSize;
+  storage.count = layout == tSL_rowMajor ? width * height : storage.chunksPerRow * ((height + TileStorageChunkSize - 1) / TileStorageChunkSize) * TileStorageChunkSize * TileStorageChunkSize;
+
+  return storage;
+}
+
+// Storage index of the tile at `x`, `y`. Doesn't divide, so loops that track tile coordinates should prefer this over `tile_storage_index`.
+template <tile_storage_layout Layout>
+inline size_t tile_storage_indexAt(const tile_storage &storage, const size_t x, const size_t y)
+{
+  if constexpr (Layout == tSL_rowMajor)
+    return y * storage.width + x;
+  else
+    return (((y / TileStorageChunkSize) * storage.chunksPerRow + x / TileStorageChunkSize) * TileStorageChunkSize + (y % TileStorageChunkSize)) * TileStorageChunkSize + (x % TileStorageChunkSize);
+}
+
+inline size_t tile_storage_indexAt(const tile_storage &storage, const size_t x, const size_t y)
+{
+  return storage.layout == tSL_rowMajor ? tile_storage_indexAt<tSL_rowMajor>(storage, x, y) : tile_storage_indexAt<tSL_chunked>(storage, x, y);
+}
+
+inline size_t tile_storage_index(const tile_storage &storage, const size_t index)
+{
+  if (storage.layout == tSL_rowMajor)
+    return index;
+
+  const size_t y = index / storage.width;
+
+  return tile_storage_indexAt<tSL_chunked>(storage, index - y * storage.width, y);
+}
+
+// Direction map of one pathfinding target: `direction`s are packed into 4 bits (two tiles per byte, even storage indices in the low nibble).
+// Distances are only stored for targets that need them, `pDistances` is `nullptr` otherwise. Both are laid out according to `storage`, so they have to be accessed through the functions below.
+static_assert(d_unfillable < 0x10, "Directions have to fit into a nibble.");
+
+struct direction_map
+{
+  uint8_t *pDirections = nullptr;
+  uint32_t *pDistances = nullptr;
+  tile_storage storage;
+};
+
+inline size_t direction_map_byteCount(const size_t tileCount)
+{
+  return (tileCount + 1) / 2;
+}
+
+// The `Stored` variants take storage indices (see `tile_storage_index`) instead of tile indices.
+inline direction direction_map_getDirStored(const direction_map &map, const size_t stored)
+{
+  return (direction)((map.pDirections[stored >> 1] >> ((stored & 1) << 2)) & 0xF);
+}
+
+inline void direction_map_setDirStored(direction_map &map, const size_t stored, const direction dir)
+{
+  const uint8_t shift = (uint8_t)((stored & 1) << 2);
+  uint8_t &packed = map.pDirections[stored >> 1];
+  packed = (uint8_t)((packed & ~(0xF << shift)) | (dir << shift));
+}
+
+inline void direction_map_setStored(direction_map &map, const size_t stored, const direction dir, const uint32_t dist)
+{
+  direction_map_setDirStored(map, stored, dir);
+
+  if (map.pDistances != nullptr)
+    map.pDistances[stored] = dist;
+}
+
+inline direction direction_map_getDir(const direction_map &map, const size_t index)
+{
+  return direction_map_getDirStored(map, tile_storage_index(map.storage, index));
+}
+
+inline void direction_map_setDir(direction_map &map, const size_t index, const direction dir)
+{
+  direction_map_setDirStored(map, tile_storage_index(map.storage, index), dir);
+}
+
+inline void direction_map_set(direction_map &map, const size_t index, const direction dir, const uint32_t dist)
+{
+  direction_map_setStored(map, tile_storage_index(map.storage, index), dir, dist);
+}
+
+inline uint32_t direction_map_getDist(const direction_map &map, const size_t index)
+{
+  return map.pDistances != nullptr ? map.pDistances[tile_storage_index(map.storage, index)] : 0;
+}
+
+static constexpr size_t MaxMapTileCount = 0xFFFFFFFF; // Tile indices are stored as `uint32_t` in the pathfinding stack. Paths are shorter than that as well, so `uint32_t` distances can't overflow.
+
 struct fill_step
 {
-  size_t index;
-  size_t dist;
+  uint32_t index;
+  uint32_t dist;
 
   inline fill_step() = default;
-  inline fill_step(const size_t idx, const size_t dist) : index(idx), dist(dist) { lsAssert(index < 16 * 16); } // Change if map size changes!
+  inline fill_step(const size_t idx, const size_t dist) : index((uint32_t)idx), dist((uint32_t)dist) { lsAssert(idx < MaxMapTileCount); }
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -124,20 +237,20 @@ struct fill_step
 struct pathfinding_element
 {
   uint8_t elevationLevel;
+  uint8_t passableNeighbors; // Bit `dir - d_topRight` is set if the neighbour in direction `dir` can be walked to. Maintained alongside elevation and collidability changes.
 };
 
 static constexpr uint8_t MaxFireResourceCount = 9;
 static constexpr uint8_t MaxFoodItemResourceCount = 255;
-static const uint8_t MaxResourceCounts[] = { 1, 1, 1, 1, 1, 1, 1, 4, MaxFireResourceCount, MaxFireResourceCount, 0 /*tT_market does not have a count*/, 12, 12, 12, 12, MaxFoodItemResourceCount, MaxFoodItemResourceCount, MaxFoodItemResourceCount, MaxFoodItemResourceCount, MaxFoodItemResourceCount, 1 };
+static constexpr uint8_t MaxResourceCounts[] = { 1, 1, 1, 1, 1, 1, 1, 4, MaxFireResourceCount, MaxFireResourceCount, 0 /*tT_market does not have a count*/, 12, 12, 12, 12, MaxFoodItemResourceCount, MaxFoodItemResourceCount, MaxFoodItemResourceCount, MaxFoodItemResourceCount, MaxFoodItemResourceCount, 1 };
 static_assert(LS_ARRAYSIZE(MaxResourceCounts) == tT_count);
 
+// Read by every full map pass, so it only holds what these need. Rarely used data goes into side tables like `level_info::multiResources`.
 struct gameplay_element
 {
   resource_type tileType;
-  uint8_t resourceCount;
-  uint8_t maxResourceCount; // A maximum Count of 1 means it is a infinte source.
-  int16_t multiResourceCountIndex = -1;
-  uint8_t tileStatus = 0; // can refer to different properties depending on the type of tile (e.g. growth status)
+  uint8_t resourceCount; // A maximum count (see `gameplay_element_maxCount`) of 1 means it is a infinte source.
+  int16_t multiResourceCountIndex = -1; // Slot in `level_info::multiResources` for multi resource tiles, -1 otherwise.
 
   //bool hasHouse;
 
@@ -145,10 +258,26 @@ struct gameplay_element
   gameplay_element(const resource_type type, const uint8_t count, const int16_t multiResourceCountIndex = -1) : tileType(type), resourceCount(count), multiResourceCountIndex(multiResourceCountIndex)
   {
     lsAssert(type < tT_count);
-    maxResourceCount = MaxResourceCounts[type];
   }
 };
 
+static_assert(sizeof(gameplay_element) == 4);
+
+inline uint8_t gameplay_element_maxCount(const gameplay_element &e)
+{
+  return MaxResourceCounts[e.tileType];
+}
+
+// Inventories of the multi resource tiles (markets and future houses), one column per `resource_type`. Slots of overwritten tiles are reused.
+struct multi_resource_store
+{
+  list<uint8_t> counts[tT_count];
+  list<uint32_t> nonEmpty; // Bitmask of the `resource_type`s with a count > 0 per slot, kept up to date by `multi_resource_modify`.
+  list<int16_t> freeSlots;
+};
+
+static_assert(tT_count <= sizeof(uint32_t) * CHAR_BIT);
+
 // TODO: maybe we want to have a struct like: 
 struct gamplay_element_transition
 {
@@ -185,83 +314,123 @@ enum actor_type
   aT_count
 };
 
+// Gameplay state of a moving actor. Position and heading live in `movement_kinematics` at the entity index of the actor.
 struct movement_actor
 {
-  vec2f pos;
-  pathfinding_target_type target;
+  pathfinding_target_type target = ptT_Count; // `ptT_Count` while the actor has nowhere to go, it stays where it is.
   bool atDestination = false;
   bool atDestinationLastTick = false;
-  vec2f direction = vec2f(0);
-  size_t lastTickTileIdx = 0;
-  bool enteredDifferentTileLastTick = false;
   bool survivalActorActive = false;
   bool isWaiting = false;
   uint16_t ticksToWait = 0;
 };
 
+enum movement_flag : uint8_t
+{
+  mF_moving = 1 << 0, // Moves along its direction this tick.
+  mF_enteredDifferentTileLastTick = 1 << 1,
+};
+
+constexpr size_t MovementLaneCount = 4; // Actors processed at once by the movement kernel.
+
+// Positions and headings of all actors, one array per component, indexed by entity index. Capacity is a multiple of `MovementLaneCount` and the padding is zeroed.
+struct movement_kinematics
+{
+  size_t count = 0, capacity = 0;
+  float_t *pPosX = nullptr, *pPosY = nullptr;
+  float_t *pPreviousPosX = nullptr, *pPreviousPosY = nullptr; // `pos` before the last tick, for interpolating between ticks.
+  float_t *pDirectionX = nullptr, *pDirectionY = nullptr;
+  uint32_t *pTileIdx = nullptr; // The tile `pos` is on.
+  uint32_t *pLastTickTileIdx = nullptr;
+  uint8_t *pFlags = nullptr; // `movement_flag`s.
+};
+
 struct lifesupport_actor
 {
   actor_type type;
-  size_t entityIndex;
   uint8_t nutritions[(_ptT_nutrient_last + 1) - _ptT_nutrient_first];
   uint8_t lunchbox[(_tile_type_food_last + 1) - _tile_type_food_first];
   uint8_t temperature;
 };
 
-struct actor // TODO: add entity type here as well and let the ls actor inheret from it?
+// Actors repeat a sequence of actions, see `ActionSequences`. All of them are updated by one system, that groups them by the kind of action they're on.
+// Actions that depend on the actor (e.g. the meal a cook is making) pick their target through `actor_planAction`, actors with a different sequence at night switch over with the day night cycle.
+
+struct drop_off_action
 {
-  size_t index;
+  resource_type destTileType;
+  resource_type item;
+  uint8_t amount;
 };
 
-// TODO: simplify actor's:
-// minimal actors that ideally all operate on the same system ((best case) one simple function to handle all) -> type of action, state: do xxx, change state. -> actors just have states correlated to specific types of actions, bound to specific items. e.g. for drop off action: item, targetTile, or
-// current actions:
-// drop off x at tile y -> could be action: targetTileType, item
-// get x                -> could be action: item (target tile type is defined by item (ptt)
-// change tile y to z   -> could be action: oridingTileType, targetTileType (that schould be changed to)
-
-// If I want to predefine everything it sadly won't work with how things go at the moment, as I can't tell upfront which cooking ingridient the cook needs to get next, or wether or not the fire actor needs to get wood... (the cook is solvable if he only ever gets as much ingridients as he needs, so he always has to get all for the current meal)
+struct get_action
+{
+  resource_type item;
+  uint8_t amount;
+};
 
-// but what I was thinking:
-struct drop_off_action
+struct change_tile_action
 {
-  const resource_type destTileType;
-  const resource_type item; // or ptt?
-  const uint8_t amount;
+  resource_type currentTileType;
+  resource_type targetTileType;
+  static constexpr uint8_t KeepResourceCount = 0xFF;
 
-  drop_off_action() = default;
-  drop_off_action(const resource_type destTileType, const resource_type item, const uint8_t amount) : destTileType(destTileType), item(item), amount(amount) {};
+  uint8_t amount; // Resource count of the changed tile, `KeepResourceCount` to keep the current one.
+  resource_type consumedItem = tT_count; // Has to be in the inventory and is used up by the change, `tT_count` if nothing is needed.
+  resource_type producedItem = tT_count; // Added to the inventory by the change, `tT_count` if nothing is produced.
 };
 
-struct get_action
+// Turns soil into the first food source that isn't available yet, or a random one.
+struct plant_action {};
+
+// Lights a fire pit. Pits that burned down to `woodPerFire` are refueled from the inventory first.
+struct light_fire_action
 {
-  const resource_type item;
-  const uint8_t amount;
+  uint8_t woodPerFire;
+};
 
-  get_action() = default;
-  get_action(const resource_type item, const uint8_t amount) : item(item), amount(amount) {};
+// Takes `amount` from a plant the actor is missing for `actor::meal`. Used up plants turn back into soil.
+struct harvest_action
+{
+  uint8_t amount;
 };
 
-struct change_tile_action
+// Turns the ingredients of `actor::meal` into `amount` of it on its drop off and moves on to the next meal.
+struct cook_action
 {
-  const resource_type currentTileType;
-  const resource_type targetTileType;
-  const uint8_t amount;
+  uint8_t amount;
+};
 
-  change_tile_action() = default;
-  change_tile_action(const resource_type currentTileType, const resource_type targetTileType, const uint8_t amount) : currentTileType(currentTileType), targetTileType(targetTileType), amount(amount) {};
+enum action_result : uint8_t
+{
+  aR_failed, // Tried again.
+  aR_missing_item, // The actor doesn't have an item the action needs, continues with `action::onMissingItem`.
+  aR_done, // Continues with `action::next`.
 };
 
 struct action
 {
-  enum
+  enum type_t : uint8_t
   {
     t_invalid,
     t_drop_off,
     t_get,
     t_change_tile,
+    t_plant,
+    t_light_fire,
+    t_harvest,
+    t_cook,
+
+    t_count
   } type = t_invalid;
 
+  static constexpr uint8_t Following = 0xFF; // The action after this one in the sequence.
+  static constexpr uint8_t Same = 0xFE; // This action again.
+
+  uint16_t waitTicks = 0; // Waited at the destination before the action is executed.
+  uint8_t next = Following; // Index in the sequence to continue with once the action is done.
+  uint8_t onMissingItem = Same; // Index in the sequence to continue with if the actor lacks an item the action needs.
+
 #pragma warning(push)
 #pragma warning(disable: 4201) // support unnamed union
   union
@@ -269,160 +438,362 @@ struct action
     drop_off_action drop_off;
     get_action get;
     change_tile_action change_tile;
+    plant_action plant;
+    light_fire_action light_fire;
+    harvest_action harvest;
+    cook_action cook;
   };
 #pragma warning(pop)
+
+  constexpr action(const drop_off_action &a, const uint16_t waitTicks = 0, const uint8_t next = Following, const uint8_t onMissingItem = Same) : type(t_drop_off), waitTicks(waitTicks), next(next), onMissingItem(onMissingItem), drop_off(a) {}
+  constexpr action(const get_action &a, const uint16_t waitTicks = 0, const uint8_t next = Following, const uint8_t onMissingItem = Same) : type(t_get), waitTicks(waitTicks), next(next), onMissingItem(onMissingItem), get(a) {}
+  constexpr action(const change_tile_action &a, const uint16_t waitTicks = 0, const uint8_t next = Following, const uint8_t onMissingItem = Same) : type(t_change_tile), waitTicks(waitTicks), next(next), onMissingItem(onMissingItem), change_tile(a) {}
+  constexpr action(const plant_action &a, const uint16_t waitTicks = 0, const uint8_t next = Following, const uint8_t onMissingItem = Same) : type(t_plant), waitTicks(waitTicks), next(next), onMissingItem(onMissingItem), plant(a) {}
+  constexpr action(const light_fire_action &a, const uint16_t waitTicks = 0, const uint8_t next = Following, const uint8_t onMissingItem = Same) : type(t_light_fire), waitTicks(waitTicks), next(next), onMissingItem(onMissingItem), light_fire(a) {}
+  constexpr action(const harvest_action &a, const uint16_t waitTicks = 0, const uint8_t next = Following, const uint8_t onMissingItem = Same) : type(t_harvest), waitTicks(waitTicks), next(next), onMissingItem(onMissingItem), harvest(a) {}
+  constexpr action(const cook_action &a, const uint16_t waitTicks = 0, const uint8_t next = Following, const uint8_t onMissingItem = Same) : type(t_cook), waitTicks(waitTicks), next(next), onMissingItem(onMissingItem), cook(a) {}
 };
 
-// TODO: how will we save the actions? maybe just save the type of action and always create new ones
+// The tile an actor has to walk to, to execute `actn`. `ptT_Count` if it depends on the actor, see `actor_planAction`.
+constexpr pathfinding_target_type action_target(const action &actn)
+{
+  switch (actn.type)
+  {
+  case action::t_drop_off: return (pathfinding_target_type)actn.drop_off.destTileType;
+  case action::t_get: return (pathfinding_target_type)actn.get.item;
+  case action::t_change_tile: return (pathfinding_target_type)actn.change_tile.currentTileType;
+  case action::t_plant: return ptT_soil;
+  case action::t_light_fire: return ptT_fire_pit;
+  default: return ptT_Count;
+  }
+}
 
-bool execute_action(const drop_off_action &actn, actor *pActor, const size_t tileIdx);
-bool execute_action(const get_action &actn, actor *pActor, const size_t tileIdx);
-bool execute_action(const change_tile_action &actn, actor *pActor, const size_t tileIdx);
+struct actor
+{
+  actor_type type;
+  bool night = false; // Whether `currentAction` is part of the night sequence of `type`.
+  uint8_t currentAction = 0; // Index in the action sequence of `type`.
+  resource_type meal = _tile_type_food_first; // What a cook is currently making.
+  uint8_t inventory[tT_count] = {};
+};
 
-inline bool execute_action(const action &actn, actor *pActor, const size_t tileIdx)
+// Errors mean that a tile change couldn't be journaled, the change itself has still happened and `*pResult` reflects it.
+lsResult execute_action(const drop_off_action &actn, actor *pActor, const size_t tileIdx, _Out_ action_result *pResult);
+lsResult execute_action(const get_action &actn, actor *pActor, const size_t tileIdx, _Out_ action_result *pResult);
+lsResult execute_action(const change_tile_action &actn, actor *pActor, const size_t tileIdx, _Out_ action_result *pResult);
+lsResult execute_action(const plant_action &actn, actor *pActor, const size_t tileIdx, _Out_ action_result *pResult);
+lsResult execute_action(const light_fire_action &actn, actor *pActor, const size_t tileIdx, _Out_ action_result *pResult);
+lsResult execute_action(const harvest_action &actn, actor *pActor, const size_t tileIdx, _Out_ action_result *pResult);
+lsResult execute_action(const cook_action &actn, actor *pActor, const size_t tileIdx, _Out_ action_result *pResult);
+
+inline lsResult execute_action(const action &actn, actor *pActor, const size_t tileIdx, _Out_ action_result *pResult)
 {
   switch (actn.type)
   {
-  case action::t_drop_off: return execute_action(actn.drop_off, pActor, tileIdx);
-  case action::t_get: return execute_action(actn.get, pActor, tileIdx);
-  case action::t_change_tile: return execute_action(actn.change_tile, pActor, tileIdx);
-  default: lsFail(); return false;
+  case action::t_drop_off: return execute_action(actn.drop_off, pActor, tileIdx, pResult);
+  case action::t_get: return execute_action(actn.get, pActor, tileIdx, pResult);
+  case action::t_change_tile: return execute_action(actn.change_tile, pActor, tileIdx, pResult);
+  case action::t_plant: return execute_action(actn.plant, pActor, tileIdx, pResult);
+  case action::t_light_fire: return execute_action(actn.light_fire, pActor, tileIdx, pResult);
+  case action::t_harvest: return execute_action(actn.harvest, pActor, tileIdx, pResult);
+  case action::t_cook: return execute_action(actn.cook, pActor, tileIdx, pResult);
+  default: lsFail(); *pResult = aR_failed; return lsR_InvalidParameter;
   }
 }
 
-//constexpr action actions[] = { ... }; // for all types of actors. this would provide the problem that only ever these actions in this order can be done, if I want to handle all in one simple function. If I have sperate functions for each actor like right now, it would ofc be possible.
-// *IF* I do not want to restrict myself to no individual handling, I also can't have any custom variables like 'currentCookingItem' etc. per actor type.
-// I think the best possibility is to still have seperate actor structs, and handle state transitions sperately but still use the generalized actions only and have functions for performing each action. but this would still keep a lot of the complexity I want to reduce...
-
 // a lot of compelxity and individuality is currently needed for the cook. how about making the cook cleaner. have an actor for each meal. that maybe even plants, waters, cooks
 // farmers/cooks can be spwaned in groups, so the player would not need to spawn a farmer fore each food type.
 
-struct actor
+//////////////////////////////////////////////////////////////////////////
+
+constexpr size_t ActorChunkCapacity = 256;
+
+// Components of up to `ActorChunkCapacity` actors of the same archetype, one array per component. Actors are never removed, so all chunks of an archetype but the last are full.
+struct actor_chunk
 {
-  const actor_type type;
-  const size_t index;
-  uint8_t currentAction = 0; // either only the index or the array/local list is saved in the actor
-  uint8_t inventory[tT_count];
+  size_t count;
+  size_t entityIndex[ActorChunkCapacity]; // Index in `game::movementKinematics`.
+  movement_actor movement[ActorChunkCapacity];
+  lifesupport_actor lifesupport[ActorChunkCapacity];
 };
 
-// something like this, not quite sure...
-//
-//void actors_do()
-//{
-//  for all actors
-//  {
-//    switch currentAction
-//    // do ...
-//  }
-//}
+// `actor_chunk` of an archetype with the role component `TRole`.
+template <typename TRole>
+struct role_chunk : actor_chunk
+{
+  TRole role[ActorChunkCapacity];
+};
 
 //////////////////////////////////////////////////////////////////////////
 
-enum lumberjack_actor_state
+// Entry of the tile change journal, see `journalTileChange`.
+struct tile_change
 {
-  laS_plant,
-  laS_getWater,
-  laS_water,
-  laS_chop,
-  laS_cut,
-  laS_drop_off,
-
-  laS_count
+  uint32_t tileIndex;
+  uint32_t affectedTargets; // Bitmask of the `pathfinding_target_type`s that the tile started or stopped matching.
+  resource_type previousType, newType;
+  uint8_t previousCount, newCount;
+  bool passabilityChanged; // e.g. the elevation changed, so the edges to all neighbours have to be reevaluated.
 };
 
-// TODO: use the actions and functions in the current system. I really should talk to coc
-struct lumberjack_actor : actor
+// Connected region of walkable tiles, see `game_canReachTarget`.
+struct tile_component
 {
-  lumberjack_actor_state state;
-  //bool hasItem; // Maybe change this to several inevntory spots if needed.
-  //resource_type item;
+  uint32_t targets; // Bitmask of the `pathfinding_target_type`s that are present in the component.
+  uint32_t targetCounts[ptT_Count - 1]; // Skipping ptT_collidable, which never is part of a component.
 };
 
-//////////////////////////////////////////////////////////////////////////
-
-struct farmer_actor : actor {};
+static constexpr uint32_t NoTileComponent = (uint32_t)-1;
 
-//////////////////////////////////////////////////////////////////////////
+enum pathfinding_update_mode : uint8_t
+{
+  pUM_rebuild, // Direction maps are refilled from scratch whenever a fill completes.
+  pUM_repair, // Direction maps are filled once and afterwards only repaired around changed tiles.
+};
 
-// only temporary
-enum cook_actor_state
+enum pathfinding_fill_engine : uint8_t
 {
-  caS_check_inventory,
-  caS_harvest,
-  caS_cook,
+  pFE_queue, // Breadth first fill, one tile at a time.
+  pFE_wavefront, // Expands a whole BFS layer at once on row bitsets.
+};
 
-  caS_count
+// Row bitsets for `pFE_wavefront`. Every row starts at a new `uint64_t`.
+struct wavefront_fill_state
+{
+  uint64_t *pFrontier = nullptr;
+  uint64_t *pNextFrontier = nullptr;
+  uint64_t *pVisited = nullptr;
+  uint64_t *pParentRows = nullptr; // Scratch rows of `wavefront_expandLayer`.
+  uint32_t dist = 0; // Distance of the tiles in `pFrontier`.
+  size_t frontierFirstRow = 0, frontierLastRow = 0;
+  bool active = false;
 };
 
-struct cook_actor : actor
+enum pathfinding_layout : uint8_t
 {
-  cook_actor_state state; // TODO: Starting State in the actor?
-  resource_type currentCookingItem;
-  uint8_t inventory[(_ptT_nutrient_last + 1) - _ptT_nutrient_first];
+  pL_flat, // Exact direction maps over the whole level.
+  pL_hierarchical, // Fields over a graph of cluster entrances, directions are only detailed inside clusters that are queried. Paths lead through the entrances, so they're approximate.
 };
 
-//////////////////////////////////////////////////////////////////////////
+static constexpr size_t PathfindingClusterSize = 16; // Width and height of a `pL_hierarchical` cluster in tiles.
+static constexpr size_t HierarchicalPathfindingMinTileCount = 512 * 512; // Levels at least this large start out with `pL_hierarchical`.
 
-enum fire_actor_state
+struct pathfinding_cluster_node
 {
-  faS_get_wood,
-  faS_start_fire,
-  faS_get_water,
-  faS_extinguish_fire,
+  uint32_t tileIndex;
+  uint32_t firstEdge, edgeCount;
+};
 
-  faS_count
+struct pathfinding_cluster_edge
+{
+  uint32_t node;
+  uint32_t cost; // 1 into the neighbouring cluster, the walking distance for nodes of the same cluster.
 };
 
-struct fire_actor : actor
+// Entrance graph of `pL_hierarchical`: nodes are tiles on the border of a cluster that can be walked into a neighbouring cluster.
+// Only the clusters around tiles whose passability changed are rebuilt, gameplay changes only reclassify the tiles.
+struct pathfinding_hierarchy
 {
-  fire_actor_state state;
-  uint8_t wood_inventory;
-  uint8_t water_inventory;
+  list<pathfinding_cluster_node> nodes; // Sorted by cluster.
+  list<uint32_t> clusterFirstNode; // Index of the first node of every cluster, plus the total node count.
+  list<pathfinding_cluster_edge> edges;
+  uint32_t *pTileTargets = nullptr; // Target mask of every tile when it was last classified.
+  uint32_t *pClusterTargets = nullptr; // Targets that have at least one tile in the cluster.
+  uint32_t *pClusterChangedTargets = nullptr; // Targets whose tiles in the cluster changed this tick.
+  list<uint32_t> changedClusters; // Clusters with `pClusterChangedTargets` set.
+  uint64_t *pDirtyClusters = nullptr; // Bitset of the clusters with passability changes since the last rebuild.
+  list<uint32_t> rebuiltClusters; // Clusters whose walking distances were computed again by the last rebuild.
+  size_t processedChangeCount = 0;
+  uint64_t graphVersion = 0; // Incremented whenever the graph is rebuilt, 0 if there is none.
+  bool graphDirty = true; // The whole graph has to be rebuilt.
+  bool clustersDirty = false; // Only the clusters in `pDirtyClusters` have to be rebuilt.
+  uint32_t rebuildBackoffTicks = 0; // Doubles with every failed rebuild.
+  uint32_t ticksUntilRebuild = 0;
 };
 
-//////////////////////////////////////////////////////////////////////////
+static constexpr size_t DefaultPathfindingStepsPerTick = 100 * (ptT_Count - 1);
+static constexpr uint32_t DefaultPathfindingEvictionTicks = 600;
+
+// Distributes the per-tick pathfinding budget between the targets. A step is one tile for `pFE_queue` and one 64 tile word of one elevation level for `pFE_wavefront`.
+// Repairs (`pUM_repair`) always run to completion and are not part of the budget.
+struct pathfinding_schedule
+{
+  size_t stepsPerTick = DefaultPathfindingStepsPerTick;
+  uint32_t evictAfterTicks = DefaultPathfindingEvictionTicks; // Direction maps that weren't queried for this many ticks and have no actors heading to them are freed.
+  uint64_t tick = 0;
+
+  // Allocation of the last tick:
+  size_t steps[ptT_Count - 1] = {};
+  uint32_t consumers[ptT_Count - 1] = {}; // `movement_actor`s heading to the target.
+  uint32_t staleTicks[ptT_Count - 1] = {}; // How many ticks the read direction map has been missing tile changes.
+};
 
 struct level_info
 {
   struct resource_info
   {
     queue<fill_step> pathfinding_queue;
-    pathfinding_info *pDirectionLookup[2] = {};
+    direction_map directionMaps[2]; // Only allocated while the target is resident, use `game_getPathfindingInfo` to query them.
     size_t write_direction_idx = 0;
+    size_t processedChangeCount = 0; // `tileChanges` up until here are already contained in the direction map (or the fill that is currently in progress).
+    bool fieldComplete = false; // Only used by `pUM_repair`: the read direction map is complete and will be repaired in place. `pathfinding_queue` is used for the repair.
+    list<uint32_t> repairInvalidated; // Tiles that lost their path during the current repair.
+    wavefront_fill_state wavefront;
+    uint64_t changeTotal = 0; // Number of journaled tile changes that affected this target.
+    uint64_t writeSeedChangeTotal = 0; // `changeTotal` when the fill in progress was seeded.
+    uint64_t readSeedChangeTotal = 0; // `changeTotal` that the read direction map is up to date with.
+    bool hasReadMap = false;
+    bool requested = false; // Queried while not resident, will be allocated and filled.
+    bool distancesQueried = false; // Keeps storing distances from now on, see `target_stores_distances`.
+    uint64_t lastQueryTick = 0;
+
+    // `pL_hierarchical` only:
+    uint32_t *pNodeDistances = nullptr; // Distance from every entrance node to the target.
+    uint32_t *pPreviousNodeDistances = nullptr;
+    uint32_t *pNodeSeedDistances = nullptr; // Distance to the closest target without leaving the cluster of the node.
+    uint64_t *pClusterDetailed = nullptr; // Bitset of the clusters with valid directions in the read direction map.
+    uint64_t *pClusterQueried = nullptr; // Bitset of the clusters queried since the last update.
+    uint64_t hierarchyGraphVersion = 0; // `pathfinding_hierarchy::graphVersion` that the node distances are based on.
   } resources[ptT_Count - 1]; // Skipping ptT_collidable - ptT_collidable always has to be last!
 
+  pathfinding_update_mode pathfindingMode = pUM_repair;
+  pathfinding_fill_engine fillEngine = pFE_queue;
+  pathfinding_layout pathfindingLayout = pL_flat;
+  pathfinding_hierarchy pathfindingHierarchy;
+  list<tile_change> tileChanges;
+  uint64_t tileChangeTotal = 0; // Number of tile changes since the level was created.
+  uint32_t unjournaledTargets = 0; // Mask of the targets affected by tile changes that couldn't be journaled, refilled from scratch by `updateFloodfill`.
+
+  // Connected components of the walkable tiles. Target changes are counted in place, passability changes relabel the whole map once it's queried again.
+  uint32_t *pTileComponents = nullptr; // Component index per tile, `NoTileComponent` for collidable tiles.
+  list<tile_component> tileComponents;
+  bool tileComponentsDirty = true;
+  pathfinding_schedule pathfindingSchedule;
+
+  // Row bitsets of all tiles per elevation level, shared between the `pFE_wavefront` fills.
+  uint64_t *pElevationMasks = nullptr;
+  uint64_t *pReachableMasks = nullptr; // Per level: the tiles of that level and the levels next to it, which can step onto it.
+  size_t elevationMaskLevelCount = 0;
+  bool elevationMasksDirty = true;
+
   bool isNight = false;
   vec2i16 playerPos;
+  rand_seed gameplaySeed; // Used for all gameplay decisions, so runs with the same `level_settings` play out the same.
 
-  list<local_list<uint8_t, tT_count>> multiResourceCounts; // We must *never* delete anything from this list, as the indizes would change otherwise!
-  // TODO: the list should propably only include the resource_types up until tT_multi_types as e.g. meals cannot be pathfound to anyways.
+  multi_resource_store multiResources;
 
   pathfinding_element *pPathfindingMap = nullptr;
   gameplay_element *pGameplayMap = nullptr;
   render_element *pRenderMap = nullptr;
   vec2s map_size;
+  tile_storage tileStorage; // Layout of newly allocated direction maps, see `game_setTileStorageLayout`.
+  int64_t neighborOffsets[2][6]; // Index offset to the neighbour in direction `dir - d_topRight`, for even and odd rows.
 };
 
 size_t worldPosToTileIndex(vec2f pos);
 
 //////////////////////////////////////////////////////////////////////////
 
+enum game_system
+{
+  gS_dayNightCycle,
+  gS_pathfinding,
+  gS_movement,
+  gS_lifesupport,
+  gS_actions,
+
+  gS_count
+};
+
 struct game
 {
   uint64_t lastUpdateTimeNs, gameStartTimeNs, lastPredictTimeNs;
+  uint64_t nextTickTimeNs; // When `game_advance` runs the next fixed tick.
 
   level_info levelInfo;
-  pool<movement_actor> movementActors;
-  pool<lifesupport_actor> lifesupportActors;
+  movement_kinematics movementKinematics;
+
+  // Actors by archetype, in spawn order.
+  list<role_chunk<actor> *> actionChunks; // All actor types, see `ActionSequences`.
+  list<actor_chunk *> actorChunks; // The chunks of all archetypes, in the order they were created.
 
   size_t tickRate = 60;
+  uint64_t systemTimeNs[gS_count] = {}; // Time spent per `game_system` since the game was initialized.
+};
+
+struct snapshot_actor
+{
+  vec2f pos, previousPos;
+  size_t index; // Entity index of the actor.
+};
+
+// Copy of everything the renderer needs, published by the simulation thread after it ticked. Acquired snapshots aren't modified until the next `game_acquireSnapshot`.
+struct game_snapshot
+{
+  vec2s map_size;
+  resource_type *pTileTypes = nullptr;
+  uint8_t *pElevations = nullptr;
+  size_t tileCapacity = 0;
+  list<snapshot_actor> actors;
+
+  pathfinding_target_type debugTarget; // The target of the first actor.
+  bool hasDebugDirections = false; // Whether `debugDirections` holds the read direction map of `debugTarget`.
+  direction_map debugDirections;
+  size_t debugDirectionCapacity = 0;
+
+  vec2i16 playerPos;
+  bool isNight = false;
+  uint64_t tickTimeNs = 0; // When the tick that produced the snapshot was due.
+  uint64_t gameStartTimeNs = 0;
+  size_t tickRate = 0;
+};
+
+struct level_settings
+{
+  vec2s mapSize = vec2s(16, 16);
+  uint64_t seed = 2; // Seeds the terrain generation and all gameplay randomness.
+  size_t actorCounts[aT_count] = { 1, 1, 1, 1 }; // The first actor of every type spawns at a fixed position, all others on random walkable tiles.
 };
 
-lsResult game_init();
+lsResult game_init(const vec2s mapSize = vec2s(16, 16));
+lsResult game_init(const level_settings &settings);
 lsResult game_tick();
+lsResult game_advance(const int64_t nowNs, _Out_ float_t *pInterpolation); // Runs all ticks that are due at `tickRate` until `nowNs`. `pInterpolation` is how far `nowNs` is between the last and the next tick.
+
+// While the simulation thread runs, the game must only be accessed through snapshots and the player input functions.
+lsResult game_startSimulationThread();
+void game_stopSimulationThread();
+lsResult game_acquireSnapshot(_Out_ const game_snapshot **ppSnapshot); // `*ppSnapshot` is `nullptr` until the first tick. Fails once the simulation thread failed.
+float_t game_snapshotInterpolation(const game_snapshot &snapshot, const int64_t nowNs);
+
+lsResult game_setPlayerMapIndex(const direction dir); // Player input is applied at the start of the next tick.
+void game_setPathfindingMode(const pathfinding_update_mode mode);
+lsResult game_setPathfindingEngine(const pathfinding_fill_engine engine);
+void game_setPathfindingBudget(const size_t stepsPerTick);
+void game_setPathfindingEvictionTicks(const uint32_t ticks);
+void game_setPathfindingLayout(const pathfinding_layout layout); // Chosen by map size when the level is initialized.
+void game_setTileStorageLayout(const tile_storage_layout layout); // Row major by default.
+lsResult game_fillDirectionMap(const pathfinding_target_type target); // Refills the direction map of `target` with the queue engine right away, ignoring the budget. Published with the next tick, e.g. for benchmarks. Only for `pL_flat`.
+bool game_getPathfindingInfo(const pathfinding_target_type target, const size_t tileIdx, _Out_ pathfinding_info *pInfo); // `dist` is only set for targets that store distances (see `game_getTargetDistance`), it's 0 otherwise.
+
+bool game_canReachTarget(const pathfinding_target_type target, const size_t tileIdx); // Whether any tile of `target` is connected to `tileIdx`. Doesn't need a direction map.
+
+static constexpr uint32_t UnreachableTargetDistance = (uint32_t)-1;
+
+struct weighted_target
+{
+  pathfinding_target_type target;
+  int64_t weight;
+};
 
-void game_setPlayerMapIndex(const direction dir);
-void game_playerSwitchTiles(const resource_type terrainType);
+// Distance queries return `false` while the distances of a target aren't available (yet). Targets that don't store distances start doing so once they're queried.
+// Distances are exact with `pL_flat`. With `pL_hierarchical` they lead through the cluster entrances, so they can be longer than the shortest path (but never shorter), `*pApproximate` is set accordingly.
+bool game_getTargetDistance(const pathfinding_target_type target, const size_t tileIdx, _Out_ uint32_t *pDist, _Out_opt_ bool *pApproximate = nullptr); // `UnreachableTargetDistance` if no tile of the target can be reached.
+bool game_getNextStepTile(const pathfinding_target_type target, const size_t tileIdx, _Out_ size_t *pNextTileIdx); // `false` if the target can't be reached, `tileIdx` itself if it's already at the target.
+bool game_getBestTarget(const weighted_target *pTargets, const size_t targetCount, const size_t tileIdx, _Out_ size_t *pBestTargetIndex); // Highest `weight - distance` of the reachable targets.
+void game_getTargetDistances(const pathfinding_target_type *pTargets, const size_t targetCount, const size_t *pTileIndices, const size_t tileCount, _Out_ uint32_t *pDistances, _Out_opt_ bool *pApproximate = nullptr); // `pDistances[tile * targetCount + target]`, targets that aren't available (yet) are `UnreachableTargetDistance`.
+lsResult game_playerSwitchTiles(const resource_type terrainType);
 
 game *game_getGame();
 size_t game_getTickRate();
+void game_setTickRate(const size_t ticksPerSecond);
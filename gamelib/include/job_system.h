@@ -0,0 +1,64 @@
+#pragma once
+
+#include "core.h"
+#include "pool.h"
+
+//////////////////////////////////////////////////////////////////////////
+
+// Work-stealing job system.
+// Every worker owns a Chase-Lev deque: the worker pushes and pops jobs at the bottom, idle workers steal from the top.
+// Threads that aren't workers submit into a shared queue and execute jobs themselves while they wait.
+
+struct job;
+
+typedef void (*job_func)(void *pUserData, const size_t index);
+
+lsResult job_system_init(const size_t workerCount = (size_t)-1); // `(size_t)-1` spawns one worker less than there are hardware threads, as waiting threads help executing jobs.
+void job_system_destroy();
+size_t job_system_workerCount();
+
+// Jobs are recycled once they finished, don't hold on to them after `job_wait` returned.
+// Creating a job while all slots are in flight helps executing other jobs until one of them finished.
+// `pParent` only finishes once all of its children finished, so children have to be created before their parent finished (e.g. from within the parent).
+job *job_create(const job_func func, void *pUserData = nullptr, const size_t index = 0, job *pParent = nullptr);
+
+// Runs `pContinuation` once `pJob` and all of its children finished. Continuations with multiple predecessors run once all of them finished.
+// Has to be called before `pJob` is run, continuations mustn't be run manually.
+lsResult job_addContinuation(job *pJob, job *pContinuation);
+
+void job_run(job *pJob);
+void job_wait(const job *pJob); // Executes other jobs until `pJob` and all of its children finished.
+bool job_isFinished(const job *pJob);
+
+//////////////////////////////////////////////////////////////////////////
+
+// Calls `func` with consecutive ranges of at least `batchSize` indices until all of [0, count) were processed and returns once all of them are done.
+void parallel_for(const size_t count, const size_t batchSize, void (*func)(void *pUserData, const size_t begin, const size_t end), void *pUserData);
+
+// Calls `func(begin, end)`.
+template <typename TFunc>
+inline void parallel_for(const size_t count, const size_t batchSize, const TFunc &func)
+{
+  parallel_for(count, batchSize, [](void *pUserData, const size_t begin, const size_t end) { (*reinterpret_cast<const TFunc *>(pUserData))(begin, end); }, const_cast<TFunc *>(&func));
+}
+
+// Calls `func(T *pItem, const size_t index)` for every item of `p`, in batches of `blocksPerBatch` pool blocks. `p` mustn't be changed structurally until this returns.
+template <typename T, size_t multiBlockAllocCount, typename TFunc>
+inline void parallel_for(pool<T, multiBlockAllocCount> &p, const size_t blocksPerBatch, const TFunc &func)
+{
+  parallel_for(p.blockCount, blocksPerBatch, [&](const size_t beginBlock, const size_t endBlock)
+    {
+      for (size_t block = beginBlock; block < endBlock; block++)
+      {
+        uint64_t mask = p.pBlockEmptyMask[block];
+
+        while (mask)
+        {
+          const size_t subIndex = (size_t)lsLowestBit(mask);
+          mask &= mask - 1;
+
+          func(&p.ppBlocks[block][subIndex], block * pool<T, multiBlockAllocCount>::BlockSize + subIndex);
+        }
+      }
+    });
+}
@@ -93,72 +93,82 @@ struct list
   inline list_const_iterator<T> begin() const { return list_const_iterator<T>(this); };
   inline size_t end() const { return count; };
 
-  inline struct
+  struct IterateReverseWrapper
   {
     list<T> *pList;
     inline list_reverse_iterator<T> begin() { return list_reverse_iterator<T>(pList); };
     inline size_t end() { return 0; };
-  } IterateReverse() { return { this }; };
+  };
+
+  inline IterateReverseWrapper IterateReverse() { return { this }; };
 
-  inline struct
+  struct IterateFromWrapper
   {
     list<T> *pList;
     size_t startIdx;
 
     inline list_iterator<T> begin()
     {
-      const list_iterator<T> it = list_iterator<T>(pList);
+      list_iterator<T> it = list_iterator<T>(pList);
       it.position = startIdx;
       return it;
     };
 
-    inline size_t end() { return count; };
-  } IterateFrom(const size_t idx) { return { this, idx }; };
+    inline size_t end() { return pList->count; };
+  };
+
+  inline IterateFromWrapper IterateFrom(const size_t idx) { return { this, idx }; };
 
-  inline struct
+  struct ConstIterateFromWrapper
   {
-    list<T> *pList;
+    const list<T> *pList;
     size_t startIdx;
 
     inline list_const_iterator<T> begin()
     {
-      const list_const_iterator<T> it = list_const_iterator<T>(pList);
+      list_const_iterator<T> it = list_const_iterator<T>(pList);
       it.position = startIdx;
       return it;
     };
 
-    inline size_t end() { return count; };
-  } IterateFrom(const size_t idx) const { return { this, idx }; };
+    inline size_t end() { return pList->count; };
+  };
+
+  inline ConstIterateFromWrapper IterateFrom(const size_t idx) const { return { this, idx }; };
 
-  inline struct
+  struct IterateReverseFromWrapper
   {
     list<T> *pList;
     size_t startIdx;
 
     inline list_reverse_iterator<T> begin()
     {
-      const list_reverse_iterator<T> it = list_reverse_iterator<T>(pList);
+      list_reverse_iterator<T> it = list_reverse_iterator<T>(pList);
       it.position = startIdx;
       return it;
     };
 
     inline size_t end() { return 0; };
-  } IterateReverseFrom(const size_t idx) { return { this, idx }; };
+  };
+
+  inline IterateReverseFromWrapper IterateReverseFrom(const size_t idx) { return { this, idx }; };
 
-  inline struct
+  struct ConstIterateReverseFromWrapper
   {
-    list<T> *pList;
+    const list<T> *pList;
     size_t startIdx;
 
     inline list_const_reverse_iterator<T> begin()
     {
-      const list_const_reverse_iterator<T> it = list_const_reverse_iterator<T>(pList);
+      list_const_reverse_iterator<T> it = list_const_reverse_iterator<T>(pList);
       it.position = startIdx;
       return it;
     };
 
     inline size_t end() { return 0; };
-  } IterateReverseFrom(const size_t idx) const { return { this, idx }; };
+  };
+
+  inline ConstIterateReverseFromWrapper IterateReverseFrom(const size_t idx) const { return { this, idx }; };
 
   T &operator [](const size_t index);
   const T &operator [](const size_t index) const;
@@ -170,8 +180,8 @@ struct list
   inline list &operator = (const list &) = delete;
 
   inline list(list &&move) :
-    count(move.count),
     pValues(move.pValues),
+    count(move.count),
     capacity(move.capacity)
   {
     move.pValues = nullptr;
@@ -93,78 +93,88 @@ struct local_list
   inline size_t end() const { return count; };
   inline constexpr size_t capacity() const { return internal_count; };
 
-  inline struct
+  struct IterateReverseWrapper
   {
     local_list<T, internal_count> *pList;
     inline local_list_reverse_iterator<T, internal_count> begin() { return local_list_reverse_iterator<T, internal_count>(pList); };
     inline size_t end() { return 0; };
-  } IterateReverse() { return { this }; };
+  };
+
+  inline IterateReverseWrapper IterateReverse() { return { this }; };
 
   ~local_list();
 
-  inline struct
+  struct IterateFromWrapper
   {
     local_list<T, internal_count> *pList;
     size_t startIdx;
 
     inline local_list_iterator<T, internal_count> begin()
     {
-      const local_list_iterator<T, internal_count> it = local_list_iterator<T, internal_count>(pList);
+      local_list_iterator<T, internal_count> it = local_list_iterator<T, internal_count>(pList);
       it.position = startIdx;
 
       return it;
     };
 
-    inline size_t end() { return count; };
-  } IterateFrom(const size_t idx) { return { this, idx }; };
+    inline size_t end() { return pList->count; };
+  };
+
+  inline IterateFromWrapper IterateFrom(const size_t idx) { return { this, idx }; };
 
-  inline struct
+  struct ConstIterateFromWrapper
   {
-    local_list<T, internal_count> *pList;
+    const local_list<T, internal_count> *pList;
     size_t startIdx;
 
     inline local_list_const_iterator<T, internal_count> begin()
     {
-      const local_list_const_iterator<T, internal_count> it = local_list_const_iterator<T, internal_count>(pList);
+      local_list_const_iterator<T, internal_count> it = local_list_const_iterator<T, internal_count>(pList);
       it.position = startIdx;
 
       return it;
     };
 
-    inline size_t end() { return count; };
-  } IterateFrom(const size_t idx) const { return { this, idx }; };
+    inline size_t end() { return pList->count; };
+  };
+
+  inline ConstIterateFromWrapper IterateFrom(const size_t idx) const { return { this, idx }; };
 
-  inline struct
+  struct IterateReverseFromWrapper
   {
     local_list<T, internal_count> *pList;
     size_t startIdx;
 
     inline local_list_reverse_iterator<T, internal_count> begin()
     {
-      const local_list_reverse_iterator<T, internal_count> it = local_list_reverse_iterator<T, internal_count>(pList);
+      local_list_reverse_iterator<T, internal_count> it = local_list_reverse_iterator<T, internal_count>(pList);
       it.position = startIdx;
 
       return it;
     };
 
     inline size_t end() { return 0; };
-  } IterateReverseFrom(const size_t idx) { return { this, idx }; };
+  };
 
-  inline struct
+  inline IterateReverseFromWrapper IterateReverseFrom(const size_t idx) { return { this, idx }; };
+
+  struct ConstIterateReverseFromWrapper
   {
-    local_list<T, internal_count> *pList;
+    const local_list<T, internal_count> *pList;
     size_t startIdx;
 
     inline local_list_const_reverse_iterator<T, internal_count> begin()
     {
-      const local_list_const_reverse_iterator<T, internal_count> it = local_list_const_reverse_iterator<T, internal_count>(pList);
+      local_list_const_reverse_iterator<T, internal_count> it = local_list_const_reverse_iterator<T, internal_count>(pList);
       it.position = startIdx;
 
       return it;
     };
 
     inline size_t end() { return 0; };
-  } IterateReverseFrom(const size_t idx) const { return { this, idx }; };
+  };
+
+  inline ConstIterateReverseFromWrapper IterateReverseFrom(const size_t idx) const { return { this, idx }; };
 
   T &operator [](const size_t index);
   const T &operator [](const size_t index) const;
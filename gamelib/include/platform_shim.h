@@ -0,0 +1,91 @@
+#pragma once
+
+// Stand-ins for the MSVC intrinsics and the Windows functions used throughout the code, so `gamelib` also builds on other platforms.
+// Only included where `_WIN32` isn't defined.
+
+#ifndef _WIN32
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <wchar.h>
+#include <inttypes.h>
+#include <x86intrin.h>
+
+#define __debugbreak() __builtin_trap()
+
+#ifndef FORCEINLINE
+#define FORCEINLINE inline __attribute__((always_inline))
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+
+typedef int32_t BOOL;
+typedef uint32_t DWORD;
+
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+
+constexpr uint32_t CP_UTF8 = 65001;
+constexpr DWORD MB_ERR_INVALID_CHARS = 0x8;
+
+constexpr DWORD ERROR_INVALID_PARAMETER = 87;
+constexpr DWORD ERROR_INSUFFICIENT_BUFFER = 122;
+constexpr DWORD ERROR_INVALID_FLAGS = 1004;
+constexpr DWORD ERROR_NO_UNICODE_TRANSLATION = 1113;
+
+DWORD GetLastError(); // Error of the last conversion that failed on this thread.
+
+// Conversions between UTF-8 and `wchar_t`, which holds UTF-32 here. Only `CP_UTF8` is supported.
+// A count of -1 converts up to and including the null terminator, a capacity of 0 only returns the required capacity. Return 0 on failure.
+int32_t MultiByteToWideChar(const uint32_t codePage, const DWORD flags, const char *string, const int32_t bytes, wchar_t *pWideString, const int32_t wideCapacity);
+int32_t WideCharToMultiByte(const uint32_t codePage, const DWORD flags, const wchar_t *wideString, const int32_t wideCount, char *pString, const int32_t capacity, const char *defaultChar, BOOL *pUsedDefaultChar);
+
+//////////////////////////////////////////////////////////////////////////
+
+inline unsigned char _BitScanForward64(unsigned long *pIndex, const uint64_t mask)
+{
+  if (mask == 0)
+    return 0;
+
+  *pIndex = (unsigned long)__builtin_ctzll(mask);
+  return 1;
+}
+
+inline unsigned char _BitScanReverse64(unsigned long *pIndex, const uint64_t mask)
+{
+  if (mask == 0)
+    return 0;
+
+  *pIndex = (unsigned long)(63 - __builtin_clzll(mask));
+  return 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline size_t strnlen_s(const char *string, const size_t maxCount)
+{
+  return string == nullptr ? 0 : strnlen(string, maxCount);
+}
+
+inline size_t wcsnlen_s(const wchar_t *string, const size_t maxCount)
+{
+  return string == nullptr ? 0 : wcsnlen(string, maxCount);
+}
+
+template <size_t TCount, typename ...Args>
+inline int sprintf_s(char (&buffer)[TCount], const char *format, Args... args)
+{
+  return snprintf(buffer, TCount, format, args...);
+}
+
+char *_ui64toa(uint64_t value, char *buffer, const int radix);
+char *_i64toa(const int64_t value, char *buffer, const int radix);
+
+#endif
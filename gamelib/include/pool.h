@@ -84,7 +84,7 @@ struct pool
   inline pool_iterator_end_marker end() { return { count }; };
   inline pool_iterator_end_marker end() const { return { count }; };
 
-  inline struct
+  struct IterateFromIteratedIndexWrapper
   {
     pool<T, multiBlockAllocCount> *pPool;
     size_t poolIndex, iteratedIndex;
@@ -101,8 +101,9 @@ struct pool
     };
 
     inline pool_iterator_end_marker end() { return { pPool->count }; };
+  };
 
-  } IterateFromIteratedIndex(const size_t poolIndex, const size_t iteratedIndex) { return { this, poolIndex, iteratedIndex }; }
+  inline IterateFromIteratedIndexWrapper IterateFromIteratedIndex(const size_t poolIndex, const size_t iteratedIndex) { return { this, poolIndex, iteratedIndex }; }
 
   inline pool() {};
   inline pool(const pool &) = delete;
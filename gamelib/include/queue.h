@@ -86,19 +86,23 @@ struct queue
     return _const_reverse_queue_iterator<T>(this);
   }
 
-  inline struct
+  struct IterateReverseWrapper
   {
     queue<T> *pQueue;
     inline _reverse_queue_iterator<T> begin() { return _reverse_queue_iterator<T>(pQueue); };
     inline _queue_iterator<T> end() { return _queue_iterator<T>(pQueue); };
-  } IterateReverse() { return { this }; };
+  };
+
+  inline IterateReverseWrapper IterateReverse() { return { this }; };
 
-  inline struct
+  struct ConstIterateReverseWrapper
   {
-    queue<T> *pQueue;
+    const queue<T> *pQueue;
     inline _const_reverse_queue_iterator<T> begin() { return _const_reverse_queue_iterator<T>(pQueue); };
     inline _const_queue_iterator<T> end() { return _const_queue_iterator<T>(pQueue); };
-  } IterateReverse() const { return { this }; };
+  };
+
+  inline ConstIterateReverseWrapper IterateReverse() const { return { this }; };
 
   T &operator [](const size_t index);
   const T &operator [](const size_t index) const;
@@ -160,7 +164,7 @@ lsResult queue_reserve(queue<T> *pQueue, const size_t newCapacity)
     pQueue->pBack = pQueue->pStart + offsetEnd;
     pQueue->pLast = pQueue->pStart + pQueue->capacity;
 
-    if (offsetStart > 0 && offsetStart + pQueue->count > pQueue->capacity)
+    if (offsetStart > 0 && offsetStart + pQueue->count >= pQueue->capacity) // Also when `pBack` wrapped around to exactly `pStart`.
     {
       const size_t wrappedCount = pQueue->count - (pQueue->capacity - offsetStart);
       memmove(pQueue->pLast, pQueue->pStart, wrappedCount * sizeof(T));
@@ -407,17 +411,19 @@ lsResult queue_clone(const queue<T> *pSource, queue<T> *pTarget)
   queue_clear(pTarget);
   LS_ERROR_CHECK(queue_reserve(pTarget, pSource->count));
 
-  const size_t offsetStart = pSource->pFront - pSource->pStart;
-  
-  if (offsetStart > 0 && offsetStart + pSource->count > pSource->capacity)
   {
-    const size_t wrappedCount = pSource->count - (pSource->capacity - offsetStart);
-    lsMemcpy(pTarget->pFront, pSource->pFront, pSource->count - wrappedCount);
-    lsMemcpy(pTarget->pFront + pSource->count - wrappedCount, pSource->pStart, wrappedCount);
-  }
-  else
-  {
-    lsMemcpy(pTarget->pFront, pSource->pFront, pSource->count);
+    const size_t offsetStart = pSource->pFront - pSource->pStart;
+
+    if (offsetStart > 0 && offsetStart + pSource->count > pSource->capacity)
+    {
+      const size_t wrappedCount = pSource->count - (pSource->capacity - offsetStart);
+      lsMemcpy(pTarget->pFront, pSource->pFront, pSource->count - wrappedCount);
+      lsMemcpy(pTarget->pFront + pSource->count - wrappedCount, pSource->pStart, wrappedCount);
+    }
+    else
+    {
+      lsMemcpy(pTarget->pFront, pSource->pFront, pSource->count);
+    }
   }
 
   pTarget->count = pSource->count;
@@ -704,7 +710,7 @@ inline _const_queue_iterator<T> &_const_queue_iterator<T>::operator++()
 
 template<typename T>
 inline _const_reverse_queue_iterator<T>::_const_reverse_queue_iterator(const queue<T> *pQueue) :
-  _const_queue_iterator(pQueue)
+  _const_queue_iterator<T>(pQueue)
 {
   this->pPos = this->pQueue->pBack;
 }
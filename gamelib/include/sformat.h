@@ -5,6 +5,8 @@
 #include <type_traits>
 #include <string>
 #include <assert.h>
+#include <math.h>
+#include <string.h>
 
 namespace utf8
 {
@@ -93,14 +95,23 @@ constexpr inline T _clamp(const T &a, const T &min, const T &max)
   return a;
 }
 
+// The integer type with the size of one of the fixed size types that isn't one of them.
+#ifdef _MSC_VER
+typedef long _sformatDistinctLong;
+typedef unsigned long _sformatDistinctULong;
+#else
+typedef long long _sformatDistinctLong;
+typedef unsigned long long _sformatDistinctULong;
+#endif
+
 constexpr inline int64_t _isEquivalentIntegerTypeSigned(int64_t) { return true; }
 constexpr inline int32_t _isEquivalentIntegerTypeSigned(int32_t) { return true; }
-constexpr inline long _isEquivalentIntegerTypeSigned(long) { return true; }
+constexpr inline _sformatDistinctLong _isEquivalentIntegerTypeSigned(_sformatDistinctLong) { return true; }
 constexpr inline int16_t _isEquivalentIntegerTypeSigned(int16_t) { return true; }
 constexpr inline int8_t _isEquivalentIntegerTypeSigned(int8_t) { return true; }
 constexpr inline uint64_t _isEquivalentIntegerTypeSigned(uint64_t) { return false; }
 constexpr inline uint32_t _isEquivalentIntegerTypeSigned(uint32_t) { return false; }
-constexpr inline unsigned long _isEquivalentIntegerTypeSigned(unsigned long) { return false; }
+constexpr inline _sformatDistinctULong _isEquivalentIntegerTypeSigned(_sformatDistinctULong) { return false; }
 constexpr inline uint16_t _isEquivalentIntegerTypeSigned(uint16_t) { return false; }
 constexpr inline uint8_t _isEquivalentIntegerTypeSigned(uint8_t) { return false; }
 
@@ -129,9 +140,9 @@ struct _unsignedEquivalent<int32_t>
 };
 
 template <>
-struct _unsignedEquivalent<long>
+struct _unsignedEquivalent<_sformatDistinctLong>
 {
-  typedef unsigned long type;
+  typedef _sformatDistinctULong type;
 };
 
 template <>
@@ -257,19 +268,19 @@ inline constexpr bool _isFloatFormattable(const T &)
 template <typename T>
 inline constexpr bool _isListFormattable(const T &)
 {
-  return _isListFormattable_t<T>::value && _isFormattable_t<_isListFormattable_t<T>::value_type>::value;
+  return _isListFormattable_t<T>::value && _isFormattable_t<typename _isListFormattable_t<T>::value_type>::value;
 }
 
 template <typename T>
 inline constexpr bool _isVectorFormattable(const T &)
 {
-  return _isVectorFormattable_t<T>::value && _isFormattable_t<_isVectorFormattable_t<T>::value_type>::value;
+  return _isVectorFormattable_t<T>::value && _isFormattable_t<typename _isVectorFormattable_t<T>::value_type>::value;
 }
 
 template <typename T>
 inline constexpr bool _isMapFormattable(const T &)
 {
-  return _isMapFormattable_t<T>::value && _isFormattable_t<_isMapFormattable_t<T>::key_type>::value && _isFormattable_t<_isMapFormattable_t<T>::value_type>::value;
+  return _isMapFormattable_t<T>::value && _isFormattable_t<typename _isMapFormattable_t<T>::key_type>::value && _isFormattable_t<typename _isMapFormattable_t<T>::value_type>::value;
 }
 
 enum sformatSignOption
@@ -393,7 +404,7 @@ struct sformatState
   sformatState(const sformatState &copy) = default;
 
   // This should only be used
-  inline sformatState operator = (const sformatState &copy)
+  inline sformatState &operator = (const sformatState &copy)
   {
     new (this) sformatState(copy);
 
@@ -402,6 +413,8 @@ struct sformatState
     textPosition = 0;
     inFormatStatement = false;
     pAllocator = &_default_sformat_allocator;
+
+    return *this;
   }
 
   inline void SetTo(const sformatState &copy)
@@ -728,7 +741,7 @@ inline size_t sformat_GetCount(const T &value, const sformatState &fs)
     else if constexpr (sizeof(value) == 4)
       goto four_bytes_decimal;
 
-    if (value >= 10000000000000000000) { numberChars = 20; break; }
+    if (value >= 10000000000000000000ULL) { numberChars = 20; break; }
     if (value >= 1000000000000000000) { numberChars = 19; break; }
     if (value >= 100000000000000000) { numberChars = 18; break; }
     if (value >= 10000000000000000) { numberChars = 17; break; }
@@ -887,7 +900,7 @@ inline size_t sformat_GetMaxBytes(const float_t, const sformatState &fs)
   constexpr size_t maxDigits = sizeof("340282346638528859811704183484516925440") - 1;
 
   if (fs.scientificNotation)
-    return _clamp(1 + 1 + fs.decimalSeparatorLength + fs.fractionalDigits + 1 + 1 + 10, fs.minChars, _max(fs.maxChars, 6ULL)); // sign + digit + decimalSeparator + decimalDigits + e + sign + exponent.
+    return _clamp(1 + 1 + fs.decimalSeparatorLength + fs.fractionalDigits + 1 + 1 + 10, fs.minChars, _max(fs.maxChars, (size_t)6)); // sign + digit + decimalSeparator + decimalDigits + e + sign + exponent.
   else
     return _clamp(1 /* sign */ + maxDigits + _sformat_GetDigitGroupingCharCount(maxDigits, fs) * fs.digitGroupingCharLength + fs.decimalSeparatorLength + fs.fractionalDigits, fs.minChars, fs.maxChars);
 }
@@ -897,7 +910,7 @@ inline size_t sformat_GetMaxBytes(const double_t, const sformatState &fs)
   constexpr size_t maxDigits = sizeof("179769313486231570814527423731704356798070567525844996598917476803157260780028538760589558632766878171540458953514382464234321326889464182768467546703537516986049910576551282076245490090389328944075868508455133942304583236903222948165808559332123348274797826204144723168738177180919299881250404026184124858368") - 1;
 
   if (fs.scientificNotation)
-    return _clamp(1 + 1 + fs.decimalSeparatorLength + fs.fractionalDigits + 1 + 1 + 10, fs.minChars, _max(fs.maxChars, 7ULL)); // sign + digit + decimalSeparator + decimalDigits + e + sign + exponent.
+    return _clamp(1 + 1 + fs.decimalSeparatorLength + fs.fractionalDigits + 1 + 1 + 10, fs.minChars, _max(fs.maxChars, (size_t)7)); // sign + digit + decimalSeparator + decimalDigits + e + sign + exponent.
   else
     return _clamp(1 /* sign */ + maxDigits + _sformat_GetDigitGroupingCharCount(maxDigits, fs) * fs.digitGroupingCharLength + fs.decimalSeparatorLength + fs.fractionalDigits, fs.minChars, fs.maxChars);
 }
@@ -1456,9 +1469,9 @@ struct FFractionalDigitsFixed
 #define _SFORMAT_FOR_EACH_7(_call, x, ...) _call(x) , _SFORMAT_FOR_EACH_6(_call, __VA_ARGS__)
 #define _SFORMAT_FOR_EACH_8(_call, x, ...) _call(x) , _SFORMAT_FOR_EACH_7(_call, __VA_ARGS__)
 
-#define SFORMAT_MACRO_COMMA_FOR_EACH(x, ...) _SFORMAT_GET_NTH_ARG(IGNORED, ##__VA_ARGS__, _SFORMAT_FOR_EACH_8, _SFORMAT_FOR_EACH_7, _SFORMAT_FOR_EACH_6, _SFORMAT_FOR_EACH_5, _SFORMAT_FOR_EACH_4, _SFORMAT_FOR_EACH_3, _SFORMAT_FOR_EACH_2, _SFORMAT_FOR_EACH_1, _SFORMAT_FOR_EACH_0)(x, ##__VA_ARGS__)
+#define SFORMAT_MACRO_COMMA_FOR_EACH(x, ...) _SFORMAT_GET_NTH_ARG(IGNORED __VA_OPT__(,) __VA_ARGS__, _SFORMAT_FOR_EACH_8, _SFORMAT_FOR_EACH_7, _SFORMAT_FOR_EACH_6, _SFORMAT_FOR_EACH_5, _SFORMAT_FOR_EACH_4, _SFORMAT_FOR_EACH_3, _SFORMAT_FOR_EACH_2, _SFORMAT_FOR_EACH_1, _SFORMAT_FOR_EACH_0)(x __VA_OPT__(,) __VA_ARGS__)
 
-#define _SFORMAT_ARG_COUNT(...) _SFORMAT_ARG_COUNT_INTERNAL(0, ## __VA_ARGS__, 70, 69, 68, 67, 66, 65, 64, 63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define _SFORMAT_ARG_COUNT(...) _SFORMAT_ARG_COUNT_INTERNAL(0 __VA_OPT__(,) __VA_ARGS__, 70, 69, 68, 67, 66, 65, 64, 63, 62, 61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
 #define _SFORMAT_ARG_COUNT_INTERNAL(_0, _1_, _2_, _3_, _4_, _5_, _6_, _7_, _8_, _9_, _10_, _11_, _12_, _13_, _14_, _15_, _16_, _17_, _18_, _19_, _20_, _21_, _22_, _23_, _24_, _25_, _26_, _27_, _28_, _29_, _30_, _31_, _32_, _33_, _34_, _35_, _36, _37, _38, _39, _40, _41, _42, _43, _44, _45, _46, _47, _48, _49, _50, _51, _52, _53, _54, _55, _56, _57, _58, _59, _60, _61, _62, _63, _64, _65, _66, _67, _68, _69, _70, count, ...) count
 
 #else
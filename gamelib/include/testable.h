@@ -8,14 +8,21 @@ typedef lsResult(*testable_func)();
 _testable_init register_testable(const char *name, testable_func func);
 lsResult run_testables();
 
+// Keeps the linker from dropping tests that nothing else references.
+#ifdef _MSC_VER
+#define _TESTABLE_KEEP_REFERENCE(name) __pragma(comment(linker, "/include:__test__" #name "__ref"))
+#else
+#define _TESTABLE_KEEP_REFERENCE(name)
+#endif
+
 #define DEFINE_TESTABLE(name) \
   lsResult test_ ## name(); \
   struct test_ ## name ## obj \
-  { const _testable_init &__test_init_; \
+  { const _testable_init __test_init_; \
     inline test_ ## name ## obj() : __test_init_(register_testable(#name, & test_ ## name)) { } \
   }; \
-  __pragma(comment(linker, "/include:__test__" #name "__ref")) \
-  extern "C" auto __test__ ## name ## __ref = test_ ## name ## obj(); \
+  _TESTABLE_KEEP_REFERENCE(name) \
+  extern "C" { auto __test__ ## name ## __ref = test_ ## name ## obj(); } \
   lsResult test_ ## name()
 
 template <size_t n>
@@ -59,7 +66,11 @@ inline void testable_print_value(const T &v, const char *desc)
   lsSetConsoleColor(lsCC_BrightCyan, lsCC_Black);
   testable_print_value_of_type(v);
   lsSetConsoleColor(lsCC_DarkCyan, lsCC_Black);
+#ifdef _MSC_VER // Without RTTI only MSVC can name the type.
   print("\t ('", typeid(T).name(), "' at 0x", FX()(reinterpret_cast<size_t>(&v)), ")\n");
+#else
+  print("\t (at 0x", FX()(reinterpret_cast<size_t>(&v)), ")\n");
+#endif
   lsResetConsoleColor();
 }
 
@@ -70,7 +81,7 @@ inline void testable_print_value(const T &v, const char *desc)
 
 #define TESTABLE_FAIL() \
   do \
-  { print_error_line("Test Failed\n at " __FUNCTION__ "\n in File '" __FILE__ "' Line " LS_STRINGIFY_VALUE(__LINE__) ".\n"); \
+  { print_error_line("Test Failed\n at ", __FUNCTION__, "\n in File '" __FILE__ "' Line " LS_STRINGIFY_VALUE(__LINE__) ".\n"); \
     __debugbreak(); \
       TESTABLE_RETURN_FAILURE(); \
   } while(0)
@@ -81,7 +92,7 @@ inline void testable_print_value(const T &v, const char *desc)
     const auto &b_ = (b); \
     \
     if (!(a_ == b_)) \
-    { print_error_line("Test Failed\n on '" #a " == " #b "'\n at " __FUNCTION__ "\n in File '" __FILE__ "' Line " LS_STRINGIFY_VALUE(__LINE__) ".\n"); \
+    { print_error_line("Test Failed\n on '" #a " == " #b "'\n at ", __FUNCTION__, "\n in File '" __FILE__ "' Line " LS_STRINGIFY_VALUE(__LINE__) ".\n"); \
       testable_print_value(a_, #a); \
       testable_print_value(b_, #b); \
       __debugbreak(); \
@@ -98,7 +109,7 @@ inline void testable_print_value(const T &v, const char *desc)
     const auto &b_ = (b); \
     \
     if (!(a_ != b_)) \
-    { print_error_line("Test Failed\n on '" #a " != " #b "'\n at " __FUNCTION__ "\n in File '" __FILE__ "' Line " LS_STRINGIFY_VALUE(__LINE__) ".\n"); \
+    { print_error_line("Test Failed\n on '" #a " != " #b "'\n at ", __FUNCTION__, "\n in File '" __FILE__ "' Line " LS_STRINGIFY_VALUE(__LINE__) ".\n"); \
       testable_print_value(a_, #a); \
       testable_print_value(b_, #b); \
       __debugbreak(); \
@@ -111,7 +122,7 @@ inline void testable_print_value(const T &v, const char *desc)
   { const lsResult __result = (functionCall); \
     \
     if (LS_FAILED(__result)) \
-    { print_error_line("Test Failed on 'LS_FAILED(" #functionCall ")'\n with Result ", lsResult_to_string(__result), " (0x", FX()(__result), ")\n at " __FUNCTION__ "\n in File '" __FILE__ "' Line " LS_STRINGIFY_VALUE(__LINE__) ".\n"); \
+    { print_error_line("Test Failed on 'LS_FAILED(" #functionCall ")'\n with Result ", lsResult_to_string(__result), " (0x", FX()(__result), ")\n at ", __FUNCTION__, "\n in File '" __FILE__ "' Line " LS_STRINGIFY_VALUE(__LINE__) ".\n"); \
       __debugbreak(); \
       TESTABLE_RETURN_FAILURE(); \
     } \
@@ -122,7 +133,7 @@ inline void testable_print_value(const T &v, const char *desc)
   { const lsResult __result = (functionCall); \
     \
     if (LS_SUCCESS(__result)) \
-    { print_error_line("Test Failed on 'LS_SUCCESS(" #functionCall ")'\n with Result ", lsResult_to_string(__result), " (0x", FX()(__result), ")\n at " __FUNCTION__ "\n in File '" __FILE__ "' Line " LS_STRINGIFY_VALUE(__LINE__) ".\n"); \
+    { print_error_line("Test Failed on 'LS_SUCCESS(" #functionCall ")'\n with Result ", lsResult_to_string(__result), " (0x", FX()(__result), ")\n at ", __FUNCTION__, "\n in File '" __FILE__ "' Line " LS_STRINGIFY_VALUE(__LINE__) ".\n"); \
       __debugbreak(); \
       TESTABLE_RETURN_FAILURE(); \
     } \
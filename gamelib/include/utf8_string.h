@@ -247,7 +247,7 @@ lsResult string_Create(_Out_ string *pString, const wchar_t *text, const size_t
 lsResult string_Create(_Out_ string *pString, const string &from);
 
 template <typename ...Args>
-__declspec(deprecated) lsResult string_CreateFormat(_Out_ string *pString, _In_ const char *formatString, Args&&... args);
+[[deprecated]] lsResult string_CreateFormat(_Out_ string *pString, _In_ const char *formatString, Args&&... args);
 
 template <typename ...Args>
 lsResult string_Format(_Out_ string *pString, Args&&... args);
@@ -612,16 +612,18 @@ inline lsResult small_string_Create(_Out_ small_string<TCount> *pStackString, _I
 
   LS_ERROR_CHECK(small_string_GetCount_Internal(text, size, &textCount, &textSize));
 
-  const bool isNotNullTerminated = *(text + textSize - 1) != '\0';
+  {
+    const bool isNotNullTerminated = *(text + textSize - 1) != '\0';
 
-  LS_ERROR_IF(textSize + isNotNullTerminated > TCount, lsR_ArgumentOutOfBounds);
+    LS_ERROR_IF(textSize + isNotNullTerminated > TCount, lsR_ArgumentOutOfBounds);
 
-  pStackString->bytes = textSize + isNotNullTerminated;
-  pStackString->count = textCount + isNotNullTerminated;
-  LS_ERROR_CHECK(mMemcpy(pStackString->text, text, textSize));
+    pStackString->bytes = textSize + isNotNullTerminated;
+    pStackString->count = textCount + isNotNullTerminated;
+    LS_ERROR_CHECK(mMemcpy(pStackString->text, text, textSize));
 
-  if (isNotNullTerminated)
-    pStackString->text[textSize] = '\0';
+    if (isNotNullTerminated)
+      pStackString->text[textSize] = '\0';
+  }
 
 epilogue:
   return result;
@@ -39,9 +39,9 @@ filter {"configurations:Release"}
 filter {"configurations:Debug"}
   targetname "%{prj.name}D"
 
-filter {"configurations:Release"}
+filter {"system:windows", "configurations:Release"}
   linkoptions { "../3rdParty/box2d/lib/box2d.lib" }
-filter {"configurations:Debug"}
+filter {"system:windows", "configurations:Debug"}
   linkoptions { "../3rdParty/box2d/lib/box2dD.lib" }
 
 filter { }
@@ -70,4 +70,9 @@ filter { "system:windows", "configurations:Release" }
 
 filter { "system:windows", "configurations:Debug" }
   ignoredefaultlibraries { "libcmt" }
+
+filter { "system:not windows" }
+  removefiles { "src/net.cpp", "src/vmath.cpp" } -- WinSock and DirectXMath.
+  buildoptions { "-msse4.1", "-maes" }
+  disablewarnings { "unknown-pragmas", "sign-compare", "switch", "type-limits", "class-memaccess", "nonnull-compare", "missing-field-initializers" }
 filter { }
\ No newline at end of file
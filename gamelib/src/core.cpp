@@ -86,8 +86,8 @@ int64_t lsGetCurrentTimeNs()
 
 uint64_t lsGetRand()
 {
-  __declspec(align(16)) static uint64_t last[2] = { (uint64_t)lsGetCurrentTimeNs(), __rdtsc() };
-  __declspec(align(16)) static uint64_t last2[2] = { ~__rdtsc(), ~(uint64_t)lsGetCurrentTimeNs() };
+  LS_ALIGN(16) static uint64_t last[2] = { (uint64_t)lsGetCurrentTimeNs(), __rdtsc() };
+  LS_ALIGN(16) static uint64_t last2[2] = { ~__rdtsc(), ~(uint64_t)lsGetCurrentTimeNs() };
 
   const __m128i a = _mm_load_si128(reinterpret_cast<__m128i *>(last));
   const __m128i b = _mm_load_si128(reinterpret_cast<__m128i *>(last2));
@@ -847,6 +847,8 @@ HANDLE lsFileOutHandle = nullptr;
 constexpr bool lsStdOutVTCodeColors = false; // Disabled by default. Code Path works but is probably slower and adds more clutter.
 bool lsStdOutForceStdIO = false;
 FILE *pStdOut = nullptr;
+#else
+FILE *lsFileOut = nullptr;
 #endif
 
 inline void lsInitConsole()
@@ -1029,6 +1031,9 @@ void lsPrintToOutput(const char *text)
   lsPrintToOutputWithLength(text, strlen(text));
 #else
   fputs(text, stdout);
+
+  if (lsFileOut != nullptr)
+    fputs(text, lsFileOut);
 #endif
 }
 
@@ -1076,6 +1081,8 @@ void lsErrorPrint(const char *text)
 lsResult lsSetOutputFilePath(const char *path, const bool append /* = true */)
 {
   lsResult result = lsR_Success;
+
+#ifdef LS_PLATFORM_WINDOWS
   HANDLE file = nullptr;
 
   wchar_t wpath[MAX_PATH];
@@ -1094,12 +1101,23 @@ lsResult lsSetOutputFilePath(const char *path, const bool append /* = true */)
 epilogue:
   if (LS_FAILED(result))
     CloseHandle(file);
+#else
+  FILE *pFile = fopen(path, append ? "ab" : "wb");
+  LS_ERROR_IF(pFile == nullptr, lsR_IOFailure);
+
+  lsResetOutputFile();
+
+  lsFileOut = pFile;
+
+epilogue:
+#endif
 
   return result;
 }
 
 void lsResetOutputFile()
 {
+#ifdef LS_PLATFORM_WINDOWS
   if (lsFileOutHandle == nullptr)
     return;
 
@@ -1108,12 +1126,28 @@ void lsResetOutputFile()
 
   FlushFileBuffers(file);
   CloseHandle(file);
+#else
+  if (lsFileOut == nullptr)
+    return;
+
+  FILE *pFile = lsFileOut;
+  lsFileOut = nullptr;
+
+  fclose(pFile);
+#endif
 }
 
 void lsFlushOutput()
 {
+#ifdef LS_PLATFORM_WINDOWS
   if (lsFileOutHandle != nullptr)
     FlushFileBuffers(lsFileOutHandle);
+#else
+  fflush(stdout);
+
+  if (lsFileOut != nullptr)
+    fflush(lsFileOut);
+#endif
 }
 
 lsPrintCallbackFunc *lsPrintCallback = &lsDefaultPrint;
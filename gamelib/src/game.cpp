@@ -1,272 +1,323 @@
 #include "game.h"
+#include "job_system.h"
 
 #include "box2d/box2d.h"
 
-//////////////////////////////////////////////////////////////////////////
+#include <thread>
+#include <mutex>
+#include <atomic>
 
-static game _Game;
+#include "testable.h"
+REGISTER_TESTABLE_FILE(10)
 
 //////////////////////////////////////////////////////////////////////////
 
-lsResult game_init_local();
-lsResult game_tick_local();
+static game _Game;
 
 //////////////////////////////////////////////////////////////////////////
 
-constexpr size_t _FloodFillSteps = 100;
+lsResult game_init_local(const level_settings &settings);
+lsResult game_tick_local();
 
 //////////////////////////////////////////////////////////////////////////
 
-static pool<lumberjack_actor> _LumberjackActors; // Do we need this in the header?
-static pool<farmer_actor> _FarmerActors; // Do we need this in the header?
-static pool<cook_actor> _CookActors; // Do we need this in the header?
-static pool<fire_actor> _FireActors; // Do we need this in the header?
-
-//////////////////////////////////////////////////////////////////////////
+typedef uint32_t target_mask; // One bit per `pathfinding_target_type`.
+static_assert(ptT_Count <= sizeof(target_mask) * CHAR_BIT);
 
-template <pathfinding_target_type p>
-struct match_resource;
+constexpr target_mask CollidableTargetBit = (target_mask)1 << ptT_collidable;
+constexpr target_mask FilledTargetsMask = CollidableTargetBit - 1; // All targets that have a direction map. ptT_collidable always has to be last!
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_grass>
+// Which pathfinding targets a tile of `resource_type` matches, depending on whether it has any resources left. Indexed by `[resource_type][resourceCount > 0]`.
+static constexpr auto TargetMaskPerResource = []()
 {
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_grass; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_grass) > 0; };
-};
+  struct { target_mask masks[tT_count][2]; } table = {};
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_soil>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_soil; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_soil) > 0; };
-};
+  for (size_t type = 0; type < tT_count; type++)
+  {
+    for (size_t hasCount = 0; hasCount < 2; hasCount++)
+    {
+      target_mask mask = 0;
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_water>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_water; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_water) > 0; };
-};
+      if (type < _tile_type_multi_types) // Up until here `resource_type`s and `pathfinding_target_type`s match.
+      {
+        mask = (target_mask)1 << type;
+      }
+      else if (type >= _tile_type_food_first && type <= _tile_type_food_last)
+      {
+        mask = (target_mask)1 << (_ptT_drop_off_first + (type - _tile_type_food_first));
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_sand>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_sand; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_sand) > 0; };
-};
+        if (hasCount)
+        {
+          if (type == tT_meal)
+          {
+            for (size_t nutrient = _ptT_nutrient_first; nutrient <= _ptT_nutrient_last; nutrient++)
+              mask |= (target_mask)1 << nutrient;
+          }
+          else
+          {
+            mask |= (target_mask)1 << (_ptT_nutrient_first + (type - _tile_type_food_first));
+          }
+        }
+      }
+      else if (type == tT_mountain)
+      {
+        mask = CollidableTargetBit;
+      }
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_sapling>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_sapling; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_sapling) > 0; };
-};
+      table.masks[type][hasCount] = mask;
+    }
+  }
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_tree>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_tree; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_tree) > 0; };
-};
+  return table;
+}();
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_trunk>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_trunk; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_trunk) > 0; };
-};
+static_assert(TargetMaskPerResource.masks[tT_tomato][0] == ((target_mask)1 << ptT_tomato_drop_off));
+static_assert(TargetMaskPerResource.masks[tT_meal][1] == (((target_mask)1 << ptT_meal_drop_off) | ((target_mask)1 << ptT_vitamin) | ((target_mask)1 << ptT_protein) | ((target_mask)1 << ptT_carbohydrates) | ((target_mask)1 << ptT_fat)));
+static_assert(TargetMaskPerResource.masks[tT_market][0] == ((target_mask)1 << ptT_market));
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_wood>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_wood; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_wood) > 0; };
-};
+// TODO handle types with tile states that are not path found towards
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_fire>
+FORCEINLINE target_mask tile_target_mask(const gameplay_element &e)
 {
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_fire; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_fire) > 0; };
-};
+  target_mask mask = TargetMaskPerResource.masks[e.tileType][e.resourceCount > 0];
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_fire_pit>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_fire_pit; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_fire_pit) > 0; };
-};
+  if (e.multiResourceCountIndex > -1)
+  {
+    for (uint32_t nonEmpty = _Game.levelInfo.multiResources.nonEmpty.pValues[e.multiResourceCountIndex]; nonEmpty; nonEmpty &= nonEmpty - 1) // Multi tiles match anything they have a count of.
+      mask |= TargetMaskPerResource.masks[lsLowestBit(nonEmpty)][1];
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_tomato_plant>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_tomato_plant; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_tomato_plant) > 0; };
-};
+    mask = (mask & ~CollidableTargetBit) | ((target_mask)1 << ptT_market); // Only correct as long as markets are the onlty multi resource tiles! Multi tiles should never be collidable.
+  }
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_bean_plant>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_bean_plant; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_bean_plant) > 0; };
-};
+  return mask;
+}
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_wheat_plant>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_wheat_plant; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_wheat_plant) > 0; };
-};
+//////////////////////////////////////////////////////////////////////////
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_sunflower_plant>
+FORCEINLINE uint8_t direction_bit(const direction dir)
 {
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_sunflower_plant; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_sunflower_plant) > 0; };
-};
+  lsAssert(dir >= d_topRight && dir <= d_topLeft);
+  return (uint8_t)(1 << (dir - d_topRight));
+}
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_vitamin>
+FORCEINLINE size_t tileNeighbor(const size_t index, const direction dir)
 {
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { return (resourceType == tT_tomato || resourceType == tT_meal) && count > 0; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_tomato) > 0 || *local_list_get(pCounts, tT_meal) > 0; };
-};
+  lsAssert(dir >= d_topRight && dir <= d_topLeft);
+  return (size_t)((int64_t)index + _Game.levelInfo.neighborOffsets[(index / _Game.levelInfo.map_size.x) & 1][dir - d_topRight]);
+}
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_protein>
+FORCEINLINE bool tile_passableTowards(const size_t index, const direction dir)
 {
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { return (resourceType == tT_bean || resourceType == tT_meal) && count > 0; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_bean) > 0 || *local_list_get(pCounts, tT_meal) > 0; };
-};
+  return !!(_Game.levelInfo.pPathfindingMap[index].passableNeighbors & direction_bit(dir));
+}
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_carbohydrates>
+uint8_t computePassableNeighbors(const size_t index)
 {
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { return (resourceType == tT_wheat || resourceType == tT_meal) && count > 0; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_wheat) > 0 || *local_list_get(pCounts, tT_meal) > 0; };
-};
+  const size_t x = index % _Game.levelInfo.map_size.x;
+  const size_t y = index / _Game.levelInfo.map_size.x;
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_fat>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { return (resourceType == tT_sunflower || resourceType == tT_meal) && count > 0; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_sunflower) > 0 || *local_list_get(pCounts, tT_meal) > 0; };
-};
+  // Border tiles never have passable neighbours, so the fills can't step outside of the map.
+  if (x == 0 || y == 0 || x + 1 >= _Game.levelInfo.map_size.x || y + 1 >= _Game.levelInfo.map_size.y || (tile_target_mask(_Game.levelInfo.pGameplayMap[index]) & CollidableTargetBit))
+    return 0;
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_tomato_drop_off>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_tomato; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_tomato) > 0; };
-};
+  const int16_t elevation = _Game.levelInfo.pPathfindingMap[index].elevationLevel;
+  uint8_t mask = 0;
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_bean_drop_off>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_bean; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_bean) > 0; };
-};
+  for (uint8_t d = d_topRight; d <= d_topLeft; d++)
+  {
+    const size_t neighbor = tileNeighbor(index, (direction)d);
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_wheat_drop_off>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_wheat; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_wheat) > 0; };
-};
+    if (!(tile_target_mask(_Game.levelInfo.pGameplayMap[neighbor]) & CollidableTargetBit) && lsAbs(elevation - (int16_t)_Game.levelInfo.pPathfindingMap[neighbor].elevationLevel) <= 1)
+      mask |= direction_bit((direction)d);
+  }
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_sunflower_drop_off>
-{
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_sunflower; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_sunflower) > 0; };
-};
+  return mask;
+}
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_meal_drop_off>
+// Recomputes the passable neighbours of `index` and all tiles around it.
+void updatePassableNeighbors(const size_t index)
 {
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_meal; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { return *local_list_get(pCounts, tT_meal) > 0; };
-};
+  const size_t x = index % _Game.levelInfo.map_size.x;
+  const size_t y = index / _Game.levelInfo.map_size.x;
+
+  // Hex neighbours are always within the surrounding 3x3 tiles.
+  for (size_t ny = (y > 0 ? y - 1 : 0); ny <= lsMin(y + 1, _Game.levelInfo.map_size.y - 1); ny++)
+    for (size_t nx = (x > 0 ? x - 1 : 0); nx <= lsMin(x + 1, _Game.levelInfo.map_size.x - 1); nx++)
+      _Game.levelInfo.pPathfindingMap[ny * _Game.levelInfo.map_size.x + nx].passableNeighbors = computePassableNeighbors(ny * _Game.levelInfo.map_size.x + nx);
+}
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_market>
+// Needed after tiles were written without going through `journalTileChange`, e.g. while generating the terrain.
+void updateAllPassableNeighbors()
 {
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_market; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { (void)pCounts; return true; }; // Only correct as long as markets are the onlty multi resource tiles!
-};
+  for (size_t i = 0; i < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y; i++)
+    _Game.levelInfo.pPathfindingMap[i].passableNeighbors = computePassableNeighbors(i);
+}
 
-template<>
-struct match_resource<pathfinding_target_type::ptT_collidable>
+void tileComponent_countTargets(const size_t index, const target_mask targets, const bool added)
 {
-  FORCEINLINE static bool resourceAttribute_matches_resource(const resource_type resourceType, const uint8_t count) { (void)count; return resourceType == tT_mountain; };
-  FORCEINLINE static bool resourceAttribute_matches_resource(const local_list<uint8_t, tT_count> *pCounts) { (void)pCounts; return false; }; // Multi tiles should never be collidable 
-};
+  const uint32_t component = _Game.levelInfo.pTileComponents[index];
 
-// TODO handle types with tile states that are not path found towards
+  if (component == NoTileComponent)
+    return;
 
-template<pathfinding_target_type p>
-void fill_resource_info(pathfinding_info *pDirectionLookup, queue<fill_step> &pathfindQueue, gameplay_element *pMap)
-{
-  lsZeroMemory(pDirectionLookup, _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+  tile_component *pComponent = list_get(&_Game.levelInfo.tileComponents, component);
 
-  for (size_t i = 0; i < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y; i++)
+  for (target_mask remaining = targets & FilledTargetsMask; remaining; remaining &= remaining - 1)
   {
-    const gameplay_element e = pMap[i];
+    const size_t target = lsLowestBit(remaining);
 
-    if ((e.multiResourceCountIndex > -1 && match_resource<p>::resourceAttribute_matches_resource(list_get(&_Game.levelInfo.multiResourceCounts, e.multiResourceCountIndex))) || (match_resource<p>::resourceAttribute_matches_resource(e.tileType, e.resourceCount)))
+    if (added)
     {
-      queue_pushBack(&pathfindQueue, fill_step(i, 0));
-      pDirectionLookup[i].dir = d_atDestination;
+      if (pComponent->targetCounts[target]++ == 0)
+        pComponent->targets |= (target_mask)1 << target;
     }
     else
     {
-      pDirectionLookup[i].dir = (direction)(d_unfillable * (direction)(match_resource<ptT_collidable>::resourceAttribute_matches_resource(e.tileType, e.resourceCount)));
+      lsAssert(pComponent->targetCounts[target] > 0);
+
+      if (--pComponent->targetCounts[target] == 0)
+        pComponent->targets &= ~((target_mask)1 << target);
+    }
+  }
+}
+
+// Labels the connected components of walkable tiles and counts the targets in each of them.
+lsResult relabelTileComponents()
+{
+  lsResult result = lsR_Success;
+
+  static list<uint32_t> _ComponentStack;
+
+  const size_t tileCount = _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y;
+
+  if (_Game.levelInfo.pTileComponents == nullptr)
+    LS_ERROR_CHECK(lsAlloc(&_Game.levelInfo.pTileComponents, tileCount));
+
+  for (size_t i = 0; i < tileCount; i++)
+    _Game.levelInfo.pTileComponents[i] = NoTileComponent;
+
+  list_clear(&_Game.levelInfo.tileComponents);
+
+  for (size_t i = 0; i < tileCount; i++)
+  {
+    if (_Game.levelInfo.pTileComponents[i] != NoTileComponent || (tile_target_mask(_Game.levelInfo.pGameplayMap[i]) & CollidableTargetBit))
+      continue;
+
+    tile_component component;
+    lsZeroMemory(&component);
+
+    const uint32_t componentIndex = (uint32_t)_Game.levelInfo.tileComponents.count;
+    LS_ERROR_CHECK(list_add(&_Game.levelInfo.tileComponents, &component));
+
+    _Game.levelInfo.pTileComponents[i] = componentIndex;
+    list_clear(&_ComponentStack);
+    LS_ERROR_CHECK(list_add(&_ComponentStack, (uint32_t)i));
+
+    while (_ComponentStack.count)
+    {
+      uint32_t current;
+      LS_ERROR_CHECK(list_pop_back_safe(&_ComponentStack, &current));
+
+      tileComponent_countTargets(current, tile_target_mask(_Game.levelInfo.pGameplayMap[current]), true);
+
+      for (uint8_t d = d_topRight; d <= d_topLeft; d++)
+      {
+        if (!tile_passableTowards(current, (direction)d))
+          continue;
+
+        const size_t neighbor = tileNeighbor(current, (direction)d);
+
+        if (_Game.levelInfo.pTileComponents[neighbor] == NoTileComponent)
+        {
+          _Game.levelInfo.pTileComponents[neighbor] = componentIndex;
+          LS_ERROR_CHECK(list_add(&_ComponentStack, (uint32_t)neighbor));
+        }
+      }
     }
   }
+
+  _Game.levelInfo.tileComponentsDirty = false;
+
+epilogue:
+  return result;
 }
 
-void rebuild_resource_info(pathfinding_info *pDirectionLookup, queue<fill_step> &pathfindQueue, gameplay_element *pResourceMap, const pathfinding_target_type type)
+//////////////////////////////////////////////////////////////////////////
+
+// Resets the write direction maps of all `targets` and seeds their queues in a single pass over the map.
+void rebuild_resource_infos(const target_mask targets)
 {
-  switch (type)
+  lsAssert(!(targets & CollidableTargetBit));
+
+  const size_t tileCount = _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y;
+  const gameplay_element *pMap = _Game.levelInfo.pGameplayMap;
+
+  direction_map *pDirectionMaps[ptT_Count - 1] = {};
+
+  for (target_mask remaining = targets; remaining; remaining &= remaining - 1)
+  {
+    level_info::resource_info &info = _Game.levelInfo.resources[lsLowestBit(remaining)];
+    lsAssert(!info.pathfinding_queue.count);
+
+    pDirectionMaps[lsLowestBit(remaining)] = &info.directionMaps[info.write_direction_idx];
+    lsZeroMemory(info.directionMaps[info.write_direction_idx].pDirections, direction_map_byteCount(info.directionMaps[info.write_direction_idx].storage.count)); // Distances are only valid where the direction is set.
+    info.processedChangeCount = _Game.levelInfo.tileChanges.count;
+    info.writeSeedChangeTotal = info.changeTotal;
+  }
+
+  for (size_t i = 0; i < tileCount; i++)
   {
-  case ptT_grass: fill_resource_info<ptT_grass>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_soil: fill_resource_info<ptT_soil>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_water: fill_resource_info<ptT_water>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_sand: fill_resource_info<ptT_sand>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_sapling: fill_resource_info<ptT_sapling>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_tree: fill_resource_info<ptT_tree>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_trunk: fill_resource_info<ptT_trunk>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_wood: fill_resource_info<ptT_wood>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_fire: fill_resource_info<ptT_fire>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_fire_pit: fill_resource_info<ptT_fire_pit>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_tomato_plant: fill_resource_info<ptT_tomato_plant>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_bean_plant: fill_resource_info<ptT_bean_plant>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_wheat_plant: fill_resource_info<ptT_wheat_plant>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_sunflower_plant: fill_resource_info<ptT_sunflower_plant>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_vitamin: fill_resource_info<ptT_vitamin>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_protein: fill_resource_info<ptT_protein>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_carbohydrates: fill_resource_info<ptT_carbohydrates>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_fat: fill_resource_info<ptT_fat>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_tomato_drop_off: fill_resource_info<ptT_tomato_drop_off>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_bean_drop_off: fill_resource_info<ptT_bean_drop_off>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_wheat_drop_off: fill_resource_info<ptT_wheat_drop_off>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_sunflower_drop_off: fill_resource_info<ptT_sunflower_drop_off>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_meal_drop_off: fill_resource_info<ptT_meal_drop_off>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_market: fill_resource_info<ptT_market>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  case ptT_collidable: fill_resource_info<ptT_collidable>(pDirectionLookup, pathfindQueue, pResourceMap); break;
-  default: lsFail(); // not implemented.
+    const target_mask mask = tile_target_mask(pMap[i]);
+
+    for (target_mask matches = mask & targets; matches; matches &= matches - 1)
+    {
+      const uint32_t target = lsLowestBit(matches);
+
+      queue_pushBack(&_Game.levelInfo.resources[target].pathfinding_queue, fill_step(i, 0));
+      direction_map_set(*pDirectionMaps[target], i, d_atDestination, 0);
+    }
+
+    if (mask & CollidableTargetBit)
+      for (target_mask remaining = targets; remaining; remaining &= remaining - 1)
+        direction_map_setDir(*pDirectionMaps[lsLowestBit(remaining)], i, d_unfillable);
   }
 }
 
 //////////////////////////////////////////////////////////////////////////
 
-void mapInit(const size_t width, const size_t height/*, bool *pCollidableMask*/)
+lsResult mapInit(const size_t width, const size_t height/*, bool *pCollidableMask*/)
 {
+  lsResult result = lsR_Success;
+
+  LS_ERROR_IF(width < 16 || height < 16, lsR_InvalidParameter); // `setTerrain` and `spawnActors` place things at fixed coordinates.
+  LS_ERROR_IF(width * height >= MaxMapTileCount, lsR_ArgumentOutOfBounds);
+
   _Game.levelInfo.map_size = { width, height };
+  _Game.levelInfo.tileStorage = tile_storage_create(_Game.levelInfo.tileStorage.layout, width, height);
+
+  for (size_t isOdd = 0; isOdd < 2; isOdd++)
+  {
+    const int64_t w = (int64_t)width;
+    const int64_t leftShift = isOdd ? 0 : -1; // Even rows are shifted to the left of odd rows.
+    int64_t *pOffsets = _Game.levelInfo.neighborOffsets[isOdd];
+
+    pOffsets[d_topRight - d_topRight] = -w + leftShift + 1;
+    pOffsets[d_right - d_topRight] = 1;
+    pOffsets[d_bottomRight - d_topRight] = w + leftShift + 1;
+    pOffsets[d_bottomLeft - d_topRight] = w + leftShift;
+    pOffsets[d_left - d_topRight] = -1;
+    pOffsets[d_topLeft - d_topRight] = -w + leftShift;
+  }
 
-  lsAllocZero(&_Game.levelInfo.pPathfindingMap, height * width);
-  lsAlloc(&_Game.levelInfo.pGameplayMap, height * width);
+  LS_ERROR_CHECK(lsAllocZero(&_Game.levelInfo.pPathfindingMap, height * width));
+  LS_ERROR_CHECK(lsAlloc(&_Game.levelInfo.pGameplayMap, height * width));
+
+  for (size_t i = 0; i < height * width; i++) // `setTile` snapshots the previous tile, so it must never be uninitialized.
+    _Game.levelInfo.pGameplayMap[i] = gameplay_element(tT_grass, 0);
   //lsAllocZero(&_Game.levelInfo.pRenderMap, height * width);
+
+epilogue:
+  return result;
 }
 
 void setMapBorder()
@@ -287,6 +338,139 @@ void setMapBorder()
   }
 }
 
+// State of a tile before it's mutated, see `journalTileChange`.
+struct tile_snapshot
+{
+  resource_type type;
+  uint8_t count;
+  target_mask targets;
+};
+
+tile_snapshot getTileSnapshot(const size_t index)
+{
+  lsAssert(index < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+
+  const gameplay_element &e = _Game.levelInfo.pGameplayMap[index];
+
+  tile_snapshot snapshot;
+  snapshot.type = e.tileType;
+  snapshot.count = e.resourceCount;
+  snapshot.targets = tile_target_mask(e);
+
+  return snapshot;
+}
+
+// Every tile mutation has to be recorded here once it's done. Only the targets that the tile started or stopped matching (according to `TargetMaskPerResource`) are invalidated,
+// everything else skips the change entirely.
+lsResult journalTileChange(const size_t index, const tile_snapshot &previous, const bool passabilityChanged = false)
+{
+  lsAssert(index < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+
+  const gameplay_element &e = _Game.levelInfo.pGameplayMap[index];
+
+  tile_change change;
+  change.tileIndex = (uint32_t)index;
+  change.previousType = previous.type;
+  change.newType = e.tileType;
+  change.previousCount = previous.count;
+  change.newCount = e.resourceCount;
+  change.passabilityChanged = passabilityChanged;
+  change.affectedTargets = previous.targets ^ tile_target_mask(e);
+
+  if (passabilityChanged || (change.affectedTargets & CollidableTargetBit)) // Paths through the tile change for everyone.
+  {
+    change.affectedTargets = FilledTargetsMask;
+    updatePassableNeighbors(index);
+    _Game.levelInfo.tileComponentsDirty = true; // Components might have been split or merged.
+  }
+  else if (!_Game.levelInfo.tileComponentsDirty)
+  {
+    const target_mask current = tile_target_mask(e);
+    tileComponent_countTargets(index, previous.targets & ~current, false);
+    tileComponent_countTargets(index, current & ~previous.targets, true);
+  }
+
+  const lsResult result = list_add(&_Game.levelInfo.tileChanges, &change);
+
+  // The tile has already changed, if the change can't be repaired the affected targets have to start over.
+  if (LS_FAILED(result))
+  {
+    _Game.levelInfo.unjournaledTargets |= change.affectedTargets & FilledTargetsMask;
+    _Game.levelInfo.pathfindingHierarchy.graphDirty = true;
+  }
+
+  _Game.levelInfo.tileChangeTotal++;
+
+  for (target_mask remaining = change.affectedTargets & FilledTargetsMask; remaining; remaining &= remaining - 1)
+    _Game.levelInfo.resources[lsLowestBit(remaining)].changeTotal++;
+
+  return result;
+}
+
+lsResult multi_resource_alloc(_Out_ int16_t *pSlot)
+{
+  lsResult result = lsR_Success;
+
+  multi_resource_store &store = _Game.levelInfo.multiResources;
+
+  if (store.freeSlots.count)
+  {
+    LS_ERROR_CHECK(list_pop_back_safe(&store.freeSlots, pSlot));
+
+    for (size_t i = 0; i < tT_count; i++)
+      store.counts[i].pValues[*pSlot] = 0;
+
+    store.nonEmpty.pValues[*pSlot] = 0;
+  }
+  else
+  {
+    lsAssert(store.nonEmpty.count < (size_t)lsMaxValue<int16_t>());
+
+    // Reserving first, so the columns can't end up with different lengths.
+    for (size_t i = 0; i < tT_count; i++)
+      LS_ERROR_CHECK(list_reserve(&store.counts[i], store.nonEmpty.count + 1));
+
+    LS_ERROR_CHECK(list_reserve(&store.nonEmpty, store.nonEmpty.count + 1));
+
+    for (size_t i = 0; i < tT_count; i++)
+      LS_ERROR_CHECK(list_add(&store.counts[i], (uint8_t)0));
+
+    LS_ERROR_CHECK(list_add(&store.nonEmpty, (uint32_t)0));
+
+    *pSlot = (int16_t)(store.nonEmpty.count - 1);
+  }
+
+epilogue:
+  return result;
+}
+
+lsResult multi_resource_free(const int16_t slot)
+{
+  lsAssert(slot > -1 && (size_t)slot < _Game.levelInfo.multiResources.nonEmpty.count);
+
+  return list_add(&_Game.levelInfo.multiResources.freeSlots, slot);
+}
+
+// Returns the amount that was actually added or removed, just like `modify_with_clamp`.
+uint8_t multi_resource_modify(const int16_t slot, const resource_type resource, const int64_t amount)
+{
+  multi_resource_store &store = _Game.levelInfo.multiResources;
+
+  lsAssert(slot > -1 && (size_t)slot < store.nonEmpty.count);
+  lsAssert(resource < tT_count);
+
+  uint8_t &count = store.counts[resource].pValues[slot];
+  const uint8_t previous = count;
+  count = (uint8_t)lsClamp<int64_t>((int64_t)count + amount, 0, lsMaxValue<uint8_t>());
+
+  if (count)
+    store.nonEmpty.pValues[slot] |= (uint32_t)1 << resource;
+  else
+    store.nonEmpty.pValues[slot] &= ~((uint32_t)1 << resource);
+
+  return (uint8_t)lsAbs((int64_t)count - previous);
+}
+
 lsResult setGameplayTile(const size_t index, const resource_type type, const uint8_t resourceCount)
 {
   lsResult result = lsR_Success;
@@ -298,30 +482,41 @@ lsResult setGameplayTile(const size_t index, const resource_type type, const uin
   int16_t multiResourceCountIndex = -1;
 
   if (type == tT_market)
+    LS_ERROR_CHECK(multi_resource_alloc(&multiResourceCountIndex));
+
   {
-    lsAssert(_Game.levelInfo.multiResourceCounts.count < lsMaxValue<int16_t>());
+    const tile_snapshot previous = getTileSnapshot(index); // Has to be taken while the previous slot is still valid.
+    const int16_t previousSlot = _Game.levelInfo.pGameplayMap[index].multiResourceCountIndex;
 
-    local_list<uint8_t, tT_count> l;
+    _Game.levelInfo.pGameplayMap[index] = gameplay_element(type, resourceCount, multiResourceCountIndex);
 
-    for (size_t i = 0; i < tT_count; i++)
-      LS_ERROR_CHECK(local_list_add(&l, (uint8_t)0));
+    LS_ERROR_CHECK(journalTileChange(index, previous)); // Before freeing the previous slot, so a failure there can't keep the change from being journaled.
 
-    LS_ERROR_CHECK(list_add(_Game.levelInfo.multiResourceCounts, l));
-    multiResourceCountIndex = (int16_t)_Game.levelInfo.multiResourceCounts.count - 1;
+    if (previousSlot > -1)
+      LS_ERROR_CHECK(multi_resource_free(previousSlot));
   }
 
-  _Game.levelInfo.pGameplayMap[index] = gameplay_element(type, resourceCount, multiResourceCountIndex);
-
 epilogue:
   return result;
 }
 
 lsResult setTile(const size_t index, const resource_type type, const uint8_t resourceCount, const uint8_t elevationLevel)
 {
+  lsResult result = lsR_Success;
+
   lsAssert(index < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
-  _Game.levelInfo.pPathfindingMap[index].elevationLevel = elevationLevel;
 
-  return setGameplayTile(index, type, resourceCount);
+  if (_Game.levelInfo.pPathfindingMap[index].elevationLevel != elevationLevel)
+  {
+    _Game.levelInfo.pPathfindingMap[index].elevationLevel = elevationLevel;
+    _Game.levelInfo.elevationMasksDirty = true;
+    LS_ERROR_CHECK(journalTileChange(index, getTileSnapshot(index), true));
+  }
+
+  LS_ERROR_CHECK(setGameplayTile(index, type, resourceCount));
+
+epilogue:
+  return result;
 }
 
 lsResult fillTerrain(const resource_type type)
@@ -341,13 +536,16 @@ epilogue:
   return result;
 }
 
-lsResult setTerrain()
+lsResult setTerrain(const uint64_t terrainSeed)
 {
   lsResult result = lsR_Success;
 
   // TODO: Terrain Generation
 
-  rand_seed seed = rand_seed(2, 2); // 2, 2 ist cool am anfang.
+  // Fixed tiles are placed by coordinate, so they end up in the same spot regardless of the map width.
+  const auto tileAt = [](const size_t x, const size_t y) { return y * _Game.levelInfo.map_size.x + x; };
+
+  rand_seed seed = rand_seed(terrainSeed, terrainSeed); // 2, 2 ist cool am anfang.
 
   for (size_t i = 0; i < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y; i++)
   {
@@ -373,19 +571,19 @@ lsResult setTerrain()
   //  _Game.levelInfo.pPathfindingMap[index].elevationLevel = 1;
   //}
 
-  //_Game.levelInfo.pGameplayMap[120].tileType = tT_fire;
-  //_Game.levelInfo.pGameplayMap[120].ressourceCount = 255;
-  _Game.levelInfo.pGameplayMap[121] = gameplay_element(tT_fire_pit, 4);
-  _Game.levelInfo.pGameplayMap[132] = gameplay_element(tT_fire_pit, 4);
-  _Game.levelInfo.pGameplayMap[145] = gameplay_element(tT_fire_pit, 4);
+  //_Game.levelInfo.pGameplayMap[tileAt(8, 7)].tileType = tT_fire;
+  //_Game.levelInfo.pGameplayMap[tileAt(8, 7)].ressourceCount = 255;
+  _Game.levelInfo.pGameplayMap[tileAt(9, 7)] = gameplay_element(tT_fire_pit, 4);
+  _Game.levelInfo.pGameplayMap[tileAt(4, 8)] = gameplay_element(tT_fire_pit, 4);
+  _Game.levelInfo.pGameplayMap[tileAt(1, 9)] = gameplay_element(tT_fire_pit, 4);
 
-  _Game.levelInfo.pGameplayMap[213] = gameplay_element(tT_tomato, 4);
-  _Game.levelInfo.pGameplayMap[214] = gameplay_element(tT_bean, 4);
-  _Game.levelInfo.pGameplayMap[215] = gameplay_element(tT_wheat, 4);
-  _Game.levelInfo.pGameplayMap[216] = gameplay_element(tT_sunflower, 4);
-  _Game.levelInfo.pGameplayMap[217] = gameplay_element(tT_meal, 4);
+  _Game.levelInfo.pGameplayMap[tileAt(5, 13)] = gameplay_element(tT_tomato, 4);
+  _Game.levelInfo.pGameplayMap[tileAt(6, 13)] = gameplay_element(tT_bean, 4);
+  _Game.levelInfo.pGameplayMap[tileAt(7, 13)] = gameplay_element(tT_wheat, 4);
+  _Game.levelInfo.pGameplayMap[tileAt(8, 13)] = gameplay_element(tT_sunflower, 4);
+  _Game.levelInfo.pGameplayMap[tileAt(9, 13)] = gameplay_element(tT_meal, 4);
 
-  LS_ERROR_CHECK(setGameplayTile(8 * 8 + 8, tT_market, 0));
+  LS_ERROR_CHECK(setGameplayTile(tileAt(8, 4), tT_market, 0));
 
   setMapBorder();
 
@@ -393,1310 +591,3840 @@ epilogue:
   return result;
 }
 
-lsResult spawnActor(const actor_type type, const vec2f pos)
+lsResult movement_kinematics_add(movement_kinematics *pKinematics, const size_t index, const vec2f pos)
 {
   lsResult result = lsR_Success;
 
-  lsAssert(type >= 0 && type < aT_count);
-  lsAssert(pos.x > 0 && pos.x < _Game.levelInfo.map_size.x && pos.y > 0 && pos.y < _Game.levelInfo.map_size.y);
-
-  constexpr pathfinding_target_type TargetPerActor[] = { ptT_sapling, ptT_soil, _ptT_nutrient_first, ptT_fire_pit };
-  lsAssert(LS_ARRAYSIZE(TargetPerActor) == aT_count);
+  lsAssert(index == pKinematics->count); // Actors are never removed, so entity indices stay dense.
+  lsAssert(_Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y <= lsMaxValue<uint32_t>());
 
-  size_t index;
+  if (pKinematics->count == pKinematics->capacity)
+  {
+    const size_t newCapacity = lsMax((size_t)64, pKinematics->capacity * 2);
+    static_assert((64 % MovementLaneCount) == 0);
+
+    LS_ERROR_CHECK(lsRealloc(&pKinematics->pPosX, newCapacity));
+    LS_ERROR_CHECK(lsRealloc(&pKinematics->pPosY, newCapacity));
+    LS_ERROR_CHECK(lsRealloc(&pKinematics->pPreviousPosX, newCapacity));
+    LS_ERROR_CHECK(lsRealloc(&pKinematics->pPreviousPosY, newCapacity));
+    LS_ERROR_CHECK(lsRealloc(&pKinematics->pDirectionX, newCapacity));
+    LS_ERROR_CHECK(lsRealloc(&pKinematics->pDirectionY, newCapacity));
+    LS_ERROR_CHECK(lsRealloc(&pKinematics->pTileIdx, newCapacity));
+    LS_ERROR_CHECK(lsRealloc(&pKinematics->pLastTickTileIdx, newCapacity));
+    LS_ERROR_CHECK(lsRealloc(&pKinematics->pFlags, newCapacity));
+
+    // The movement kernel processes whole lanes, the padding has to hold valid positions that never move.
+    const size_t added = newCapacity - pKinematics->capacity;
+    lsZeroMemory(pKinematics->pPosX + pKinematics->capacity, added);
+    lsZeroMemory(pKinematics->pPosY + pKinematics->capacity, added);
+    lsZeroMemory(pKinematics->pPreviousPosX + pKinematics->capacity, added);
+    lsZeroMemory(pKinematics->pPreviousPosY + pKinematics->capacity, added);
+    lsZeroMemory(pKinematics->pDirectionX + pKinematics->capacity, added);
+    lsZeroMemory(pKinematics->pDirectionY + pKinematics->capacity, added);
+    lsZeroMemory(pKinematics->pTileIdx + pKinematics->capacity, added);
+    lsZeroMemory(pKinematics->pLastTickTileIdx + pKinematics->capacity, added);
+    lsZeroMemory(pKinematics->pFlags + pKinematics->capacity, added);
+
+    pKinematics->capacity = newCapacity;
+  }
 
-  movement_actor actor;
-  actor.target = TargetPerActor[type];
-  actor.pos = pos;
+  pKinematics->pPosX[index] = pKinematics->pPreviousPosX[index] = pos.x;
+  pKinematics->pPosY[index] = pKinematics->pPreviousPosY[index] = pos.y;
+  pKinematics->pDirectionX[index] = pKinematics->pDirectionY[index] = 0;
+  pKinematics->pTileIdx[index] = 0; // Set by `movementActor_updateTileIndices` once all actors are spawned.
+  pKinematics->pLastTickTileIdx[index] = 0;
+  pKinematics->pFlags[index] = 0;
+  pKinematics->count++;
 
-  LS_ERROR_CHECK(pool_add(&_Game.movementActors, actor, &index));
+epilogue:
+  return result;
+}
 
-  lifesupport_actor ls_actor;
-  ls_actor.type = type;
-  ls_actor.entityIndex = index;
-  ls_actor.temperature = 255;
+void movementActor_updateTileIndices();
 
-  lsZeroMemory(ls_actor.nutritions, LS_ARRAYSIZE(ls_actor.nutritions));
-  lsZeroMemory(ls_actor.lunchbox, LS_ARRAYSIZE(ls_actor.lunchbox));
+inline vec2f movementActor_pos(const size_t index)
+{
+  return vec2f(_Game.movementKinematics.pPosX[index], _Game.movementKinematics.pPosY[index]);
+}
 
-  LS_ERROR_CHECK(pool_insertAt(&_Game.lifesupportActors, &ls_actor, index));
+inline size_t movementActor_tileIndex(const size_t index)
+{
+  return _Game.movementKinematics.pTileIdx[index];
+}
 
-  switch (type)
-  {
-  case aT_lumberjack:
-  {
-    lumberjack_actor lj_actor;
-    lj_actor.state = laS_plant;
-    lj_actor.index = index;
-    lj_actor.hasItem = false;
+static constexpr action LumberjackActions[] =
+{
+  change_tile_action { tT_soil, tT_sapling, MaxResourceCounts[tT_sapling] }, // plant
+  get_action { tT_water, 1 },
+  change_tile_action { tT_sapling, tT_tree, MaxResourceCounts[tT_tree], tT_water }, // water
+  change_tile_action { tT_tree, tT_trunk, MaxResourceCounts[tT_trunk] }, // chop
+  action(change_tile_action { tT_trunk, tT_soil, MaxResourceCounts[tT_soil], tT_count, tT_wood }, 100), // cut
+  drop_off_action { tT_market, tT_wood, 4 },
+};
 
-    LS_ERROR_CHECK(pool_insertAt(&_LumberjackActors, &lj_actor, index));
+static constexpr action FarmerActions[] =
+{
+  plant_action {},
+};
 
-    break;
-  }
-  case aT_cook:
-  {
-    cook_actor cook;
-    cook.state = caS_check_inventory;
-    cook.currentCookingItem = tT_tomato;
-    lsZeroMemory(cook.inventory, LS_ARRAYSIZE(cook.inventory));
+// Harvests until it has all ingredients of its meal, then cooks it.
+static constexpr action CookActions[] =
+{
+  harvest_action { 4 },
+  cook_action { 24 },
+};
 
-    cook.index = index;
+static constexpr action FireActorDayActions[] =
+{
+  action(change_tile_action { tT_fire, tT_fire_pit, change_tile_action::KeepResourceCount, tT_water }, 0, 0, 1), // extinguish
+  action(get_action { tT_water, 4 }, 0, 0),
+};
 
-    lsZeroMemory(cook.inventory, LS_ARRAYSIZE(cook.inventory));
+static constexpr action FireActorNightActions[] =
+{
+  action(light_fire_action { 3 }, 0, 0, 1),
+  action(get_action { tT_wood, 6 }, 0, 0),
+};
 
-    LS_ERROR_CHECK(pool_insertAt(&_CookActors, cook, index));
+struct action_sequence
+{
+  const action *pActions;
+  uint8_t count;
+  bool interruptsSurvival; // Actors stop looking for food or warmth while following this sequence.
+};
 
-    break;
-  }
-  case aT_farmer:
-  {
-    farmer_actor farmer;
-    farmer.index = index;
+template <size_t Count>
+constexpr action_sequence action_sequence_of(const action (&actions)[Count], const bool interruptsSurvival = false)
+{
+  return { actions, (uint8_t)Count, interruptsSurvival };
+}
 
-    LS_ERROR_CHECK(pool_insertAt(&_FarmerActors, farmer, index));
+// The sequence of each actor type at day and at night.
+static constexpr action_sequence ActionSequences[aT_count][2] =
+{
+  { action_sequence_of(LumberjackActions), action_sequence_of(LumberjackActions) },
+  { action_sequence_of(FarmerActions), action_sequence_of(FarmerActions) },
+  { action_sequence_of(CookActions), action_sequence_of(CookActions) },
+  { action_sequence_of(FireActorDayActions), action_sequence_of(FireActorNightActions, true) },
+};
 
-    break;
-  }
-  case aT_fire_actor:
+static_assert(aT_lumberjack == 0 && aT_farmer == 1 && aT_cook == 2 && aT_fire_actor == 3);
+
+constexpr bool action_sequences_valid()
+{
+  for (const action_sequence (&sequences)[2] : ActionSequences)
   {
-    fire_actor fireActor;
-    fireActor.state = faS_start_fire;
-    fireActor.wood_inventory = 0;
-    fireActor.water_inventory = 0;
+    for (const action_sequence &sequence : sequences)
+    {
+      if (sequence.count == 0)
+        return false;
 
-    fireActor.index = index;
+      for (uint8_t i = 0; i < sequence.count; i++)
+      {
+        const action &actn = sequence.pActions[i];
 
-    LS_ERROR_CHECK(pool_insertAt(&_FireActors, fireActor, index));
+        if (actn.type == action::t_invalid || actn.type >= action::t_count)
+          return false;
 
-    break;
-  }
-  default:
-  {
-    lsFail(); // not implemented.
-  }
+        if (action_target(actn) >= ptT_Count && actn.type != action::t_harvest && actn.type != action::t_cook)
+          return false;
+
+        if ((actn.next >= sequence.count && actn.next != action::Following) || (actn.onMissingItem >= sequence.count && actn.onMissingItem != action::Same))
+          return false;
+      }
+    }
   }
 
-epilogue:
-  return result;
+  return true;
 }
 
-lsResult spawnActors()
+static_assert(action_sequences_valid());
+
+static constexpr uint8_t IngridientAmountPerFood[(_tile_type_food_last + 1) - _tile_type_food_first][(_ptT_nutrient_last + 1) - _ptT_nutrient_first] =
+{ // nutrients: ptT_vitamin, ptT_protein, ptT_carbohydrates, ptT_fat. Harvested into the inventory as the corresponding plant.
+  { 1, 0, 0, 0 }, // tT_tomato
+  { 0, 1, 0, 0 }, // tT_bean
+  { 0, 0, 1, 0 }, // tT_wheat
+  { 0, 0, 0, 1 }, // tT_sunflower
+  { 1, 1, 1, 1 } // tT_meal
+};
+
+resource_type getNextCookItem(const resource_type currentItem, const size_t tileIdx)
 {
-  lsResult result = lsR_Success;
+  resource_type ret = currentItem;
 
-  LS_ERROR_CHECK(spawnActor(aT_lumberjack, vec2f((float_t)(4 % _Game.levelInfo.map_size.x), (float_t)(4 % _Game.levelInfo.map_size.y))));
-  LS_ERROR_CHECK(spawnActor(aT_farmer, vec2f(10.f, 8.f)));
-  LS_ERROR_CHECK(spawnActor(aT_cook, vec2f(12.f, 10.f)));
-  LS_ERROR_CHECK(spawnActor(aT_fire_actor, vec2f(13.f, 13.f)));
+  for (size_t i = _tile_type_food_first; i <= _tile_type_food_last; i++)
+  {
+    lsAssert(ret >= _tile_type_food_first && ret <= _tile_type_food_last);
+    ret = (resource_type)((((ret - _tile_type_food_first) + 1) % (_tile_type_food_last + 1 - _tile_type_food_first)) + _tile_type_food_first);
 
-epilogue:
-  return result;
+    // check if there is a drop off for the item so we don't get stuck. (Maybe remove in the future, if we *want* actors to be stuck, when the right tiles weren't provided)
+    if (game_canReachTarget((pathfinding_target_type)((ret - _tile_type_food_first) + _ptT_drop_off_first), tileIdx))
+      break;
+  }
+
+  return ret;
 }
 
-void initializeLevel()
+inline const action_sequence &actor_sequence(const actor *pActor)
 {
-  mapInit(16, 16);
-  lsAssert(setTerrain() == lsR_Success);
-  //lsAssert(fillTerrain(tT_grass) == lsR_Success);
+  return ActionSequences[pActor->type][pActor->night];
+}
 
-  // Set up floodfill queue and lookup
-  for (size_t i = 0; i < ptT_Count - 1; i++) // Skip ptT_collidable
+// The tile `pActor` has to walk to for `actn`, `ptT_Count` if there's nothing to do for it right now. Cooks that can't make their meal move on to the next one.
+pathfinding_target_type actor_planAction(actor *pActor, const action &actn, const size_t tileIdx)
+{
+  switch (actn.type)
+  {
+  case action::t_harvest:
   {
-    lsAllocZero(&_Game.levelInfo.resources[i].pDirectionLookup[0], _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
-    lsAllocZero(&_Game.levelInfo.resources[i].pDirectionLookup[1], _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+    lsAssert(pActor->meal >= _tile_type_food_first && pActor->meal <= _tile_type_food_last);
+
+    bool anyItemMissing = false;
+
+    for (size_t i = 0; i < LS_ARRAYSIZE(IngridientAmountPerFood[0]); i++)
+    {
+      if (pActor->inventory[_tile_type_food_resources_first + i] >= IngridientAmountPerFood[pActor->meal - _tile_type_food_first][i])
+        continue;
+
+      anyItemMissing = true;
+
+      const pathfinding_target_type targetPlant = (pathfinding_target_type)(i + _ptT_nutrient_sources_first);
 
-    rebuild_resource_info(_Game.levelInfo.resources[i].pDirectionLookup[_Game.levelInfo.resources[i].write_direction_idx], _Game.levelInfo.resources[i].pathfinding_queue, _Game.levelInfo.pGameplayMap, (pathfinding_target_type)(i));
+      if (game_canReachTarget(targetPlant, tileIdx))
+        return targetPlant;
+    }
+
+    if (anyItemMissing) // if none of the required plants is available, set new target meal. (Maybe remove in the future, if we *want* actors to be stuck, when the right tiles weren't provided)
+      pActor->meal = getNextCookItem(pActor->meal, tileIdx);
+
+    return ptT_Count;
   }
 
-  lsAssert(spawnActors() == lsR_Success);
-  _Game.levelInfo.playerPos = vec2i16((int16_t)(_Game.levelInfo.map_size.x * 0.5), (int16_t)(_Game.levelInfo.map_size.y * 0.5));
-}
+  case action::t_cook:
+  {
+    lsAssert(pActor->meal >= _tile_type_food_first && pActor->meal <= _tile_type_food_last);
 
-//////////////////////////////////////////////////////////////////////////
+    for (size_t i = 0; i < LS_ARRAYSIZE(IngridientAmountPerFood[0]); i++)
+      if (pActor->inventory[_tile_type_food_resources_first + i] < IngridientAmountPerFood[pActor->meal - _tile_type_food_first][i])
+        return ptT_Count;
 
-#ifndef _DEBUG
-__declspec(__forceinline)
-#endif
-void floodfill_suggestNextTarget(queue<fill_step> &pathfindQueue, pathfinding_info *pDirectionLookup, const size_t nextIndex, const direction dir, const uint8_t parentElevation, const size_t parentDist, const pathfinding_element *pPathfindingMap)
-{
-  direction nextTile = (direction)pDirectionLookup[nextIndex].dir;
+    const pathfinding_target_type targetDropOff = (pathfinding_target_type)(_ptT_drop_off_first + (pActor->meal - _tile_type_food_first));
+    lsAssert(targetDropOff >= _ptT_drop_off_first && targetDropOff <= _ptT_drop_off_last);
+
+    if (!game_canReachTarget(targetDropOff, tileIdx)) // (Maybe remove in the future, if we *want* actors to be stuck, when the right tiles weren't provided)
+    {
+      pActor->meal = getNextCookItem(pActor->meal, tileIdx);
+      return ptT_Count;
+    }
 
-  if (nextTile == d_unreachable && lsAbs((int8_t)parentElevation - (int8_t)pPathfindingMap[nextIndex].elevationLevel) <= 1)
+    return targetDropOff;
+  }
+
+  default:
   {
-    pathfinding_info p;
-    p.dir = dir;
-    p.dist = (uint8_t)lsClamp((uint16_t)(parentDist + 1), (uint16_t)0, (uint16_t)255);
-    pDirectionLookup[nextIndex] = p;
-    queue_pushBack(&pathfindQueue, fill_step(nextIndex, p.dist));
+    return action_target(actn);
+  }
   }
 }
 
-bool floodfill(queue<fill_step> &pathfindQueue, pathfinding_info *pDirectionLookup, const pathfinding_element *pPathfindingMap)
+// Continues with action `actionIndex` of the actor's sequence and walks towards it. Actions that have nothing to do are skipped, if none has, the actor stays where it is and tries again next tick.
+void actor_beginAction(actor *pActionActor, movement_actor *pActor, uint8_t actionIndex, const size_t tileIdx)
 {
-  fill_step current;
-  size_t stepCount = 0;
+  const action_sequence &sequence = actor_sequence(pActionActor);
 
-  while (pathfindQueue.count)
+  for (uint8_t i = 0; i < sequence.count; i++)
   {
-    if (stepCount > _FloodFillSteps)
-      return false;
+    pActionActor->currentAction = actionIndex;
 
-    queue_popFront(&pathfindQueue, &current);
-    lsAssert(current.index >= 0 && current.index < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+    const pathfinding_target_type target = actor_planAction(pActionActor, sequence.pActions[actionIndex], tileIdx);
 
-    const size_t isOddBit = (current.index / _Game.levelInfo.map_size.x) & 1;
-    const size_t topLeftIndex = current.index - _Game.levelInfo.map_size.x - (size_t)!isOddBit;
-    const size_t bottomLeftIndex = current.index + _Game.levelInfo.map_size.x - (size_t)!isOddBit;
+    if (target != ptT_Count)
+    {
+      if (pActor->target != target)
+      {
+        pActor->target = target;
+        pActor->atDestination = false;
+      }
 
-    floodfill_suggestNextTarget(pathfindQueue, pDirectionLookup, current.index - 1, d_left, pPathfindingMap[current.index].elevationLevel, current.dist, pPathfindingMap);
-    floodfill_suggestNextTarget(pathfindQueue, pDirectionLookup, current.index + 1, d_right, pPathfindingMap[current.index].elevationLevel, current.dist, pPathfindingMap);
-    floodfill_suggestNextTarget(pathfindQueue, pDirectionLookup, bottomLeftIndex, d_bottomLeft, pPathfindingMap[current.index].elevationLevel, current.dist, pPathfindingMap);
-    floodfill_suggestNextTarget(pathfindQueue, pDirectionLookup, bottomLeftIndex + 1, d_bottomRight, pPathfindingMap[current.index].elevationLevel, current.dist, pPathfindingMap); // bottomRight and bottomLeft are flipped to not give the right side all the paths
-    floodfill_suggestNextTarget(pathfindQueue, pDirectionLookup, topLeftIndex, d_topLeft, pPathfindingMap[current.index].elevationLevel, current.dist, pPathfindingMap);
-    floodfill_suggestNextTarget(pathfindQueue, pDirectionLookup, topLeftIndex + 1, d_topRight, pPathfindingMap[current.index].elevationLevel, current.dist, pPathfindingMap);
+      return;
+    }
 
-    stepCount++;
+    actionIndex = (uint8_t)((actionIndex + 1) % sequence.count);
   }
 
-  // if queue is empty: floodfill completed
-  return true;
+  pActor->target = ptT_Count;
+  pActor->atDestination = false;
 }
 
-void updateFloodfill()
+// Makes sure the last chunk of an archetype has room for another actor, starting a new chunk once it's full.
+template <typename TRole>
+lsResult actor_archetype_reserve(list<role_chunk<TRole> *> *pChunks)
 {
-  for (size_t i = 0; i < ptT_Count - 1; i++) // Skip ptT_collidable
-  {
-    size_t writeIndex = _Game.levelInfo.resources[i].write_direction_idx;
+  lsResult result = lsR_Success;
 
-    if (floodfill(_Game.levelInfo.resources[i].pathfinding_queue, _Game.levelInfo.resources[i].pDirectionLookup[writeIndex], _Game.levelInfo.pPathfindingMap))
-    {
-      lsAssert(!_Game.levelInfo.resources[i].pathfinding_queue.count);
+  role_chunk<TRole> *pChunk = pChunks->count ? pChunks->pValues[pChunks->count - 1] : nullptr;
+  role_chunk<TRole> *pNewChunk = nullptr;
 
-      size_t newWriteIndex = 1 - writeIndex;
-      _Game.levelInfo.resources[i].write_direction_idx = newWriteIndex;
+  if (pChunk == nullptr || pChunk->count == ActorChunkCapacity)
+  {
+    LS_ERROR_CHECK(lsAllocZero(&pNewChunk));
+    LS_ERROR_CHECK(list_add(pChunks, pNewChunk));
 
-      lsZeroMemory(_Game.levelInfo.resources[i].pDirectionLookup[newWriteIndex], _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+    result = list_add(&_Game.actorChunks, static_cast<actor_chunk *>(pNewChunk));
 
-      rebuild_resource_info(_Game.levelInfo.resources[i].pDirectionLookup[_Game.levelInfo.resources[i].write_direction_idx], _Game.levelInfo.resources[i].pathfinding_queue, _Game.levelInfo.pGameplayMap, (pathfinding_target_type)i);
+    if (LS_FAILED(result))
+    {
+      list_pop_back(*pChunks); // Freed below, all chunks of an archetype have to be in `game::actorChunks`.
+      goto epilogue;
     }
+
+    pNewChunk = nullptr;
   }
-}
 
-//////////////////////////////////////////////////////////////////////////
+epilogue:
+  lsFreePtr(&pNewChunk);
+  return result;
+}
 
-size_t worldPosToTileIndex(const vec2f pos)
+// Appends an actor to the last chunk of an archetype, see `actor_archetype_reserve`.
+template <typename TRole>
+void actor_archetype_add(list<role_chunk<TRole> *> *pChunks, const size_t entityIndex, const movement_actor &movement, const lifesupport_actor &lifesupport, const TRole &role)
 {
-  const float_t x_even = lsFloor(lsClamp(pos.x, 0.f, (float_t)_Game.levelInfo.map_size.x) + 0.5f);
-  const float_t y_even = lsFloor(lsClamp(pos.y, 0.f, (float_t)_Game.levelInfo.map_size.y) * 0.5f + 0.5f) * 2.f;
-
-  const float_t x_odd = lsFloor(lsClamp(pos.x, 0.f, (float_t)_Game.levelInfo.map_size.x)); // x_even is shifted by -0.5 compared to the world pos.
-  const float_t y_odd = lsFloor(lsClamp((pos.y - 1) * 0.5f, 0.f, (float_t)_Game.levelInfo.map_size.y) + 0.5f) * 2.f + 1.f;
-
-  //const float_t dist_even = lsAbs((x_even + y_even) - (pos.x + pos.y));
-  //const float_t dist_odd = lsAbs((x_odd + 0.5f + y_odd) - (pos.x + pos.y));
+  lsAssert(pChunks->count > 0);
 
-  const float_t dist_even = vec2f(x_even - pos.x, y_even - pos.y).LengthSquared();
-  const float_t dist_odd = vec2f(x_odd - (pos.x - 0.5f), y_odd - pos.y).LengthSquared();
+  role_chunk<TRole> *pChunk = pChunks->pValues[pChunks->count - 1];
+  lsAssert(pChunk->count < ActorChunkCapacity); // Reserved by `actor_archetype_reserve`.
 
-  if (dist_even < dist_odd)
-    return (size_t)lsRound(y_even * _Game.levelInfo.map_size.x + x_even);
-  else
-    return (size_t)lsRound(y_odd * _Game.levelInfo.map_size.x + x_odd);
+  pChunk->entityIndex[pChunk->count] = entityIndex;
+  pChunk->movement[pChunk->count] = movement;
+  pChunk->lifesupport[pChunk->count] = lifesupport;
+  pChunk->role[pChunk->count] = role;
+  pChunk->count++;
 }
 
-vec2f tileIndexToWorldPos(const size_t tileIndex)
+lsResult spawnActor(const actor_type type, const vec2f pos)
 {
-  const size_t x_center = tileIndex % _Game.levelInfo.map_size.x;
-  const size_t y_center = tileIndex / _Game.levelInfo.map_size.x;
+  lsResult result = lsR_Success;
 
-  vec2f tilePos = vec2f(vec2s(x_center, y_center));
+  lsAssert(type >= 0 && type < aT_count);
+  lsAssert(pos.x > 0 && pos.x < _Game.levelInfo.map_size.x && pos.y > 0 && pos.y < _Game.levelInfo.map_size.y);
 
-  if (y_center & 1) // every second row is shifted by + 0.5
-    tilePos.x += 0.5f;
+  const size_t index = _Game.movementKinematics.count;
 
-  return tilePos;
-}
+  actor actionActor;
+  actionActor.type = type;
+  actionActor.night = _Game.levelInfo.isNight;
 
-static size_t r = 0;
+  movement_actor movement;
+  actor_beginAction(&actionActor, &movement, 0, worldPosToTileIndex(pos));
 
-void movementActor_move()
-{
-  r = (r + 1) & 63;
+  lifesupport_actor ls_actor;
+  ls_actor.type = type;
+  ls_actor.temperature = 255;
 
-  for (auto _actor : _Game.movementActors)
-  {
-    movement_actor *pActor = _actor.pItem;
+  lsZeroMemory(ls_actor.nutritions, LS_ARRAYSIZE(ls_actor.nutritions));
+  lsZeroMemory(ls_actor.lunchbox, LS_ARRAYSIZE(ls_actor.lunchbox));
 
-    // Reset lastTile every so often to handle map changes.
-    if ((_actor.index & 63) == r)
-      pActor->lastTickTileIdx = (size_t)(_Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y * 0.5);
+  // Everything that can fail happens before the entity exists, so a failed spawn doesn't leave an entity without components behind.
+  LS_ERROR_CHECK(actor_archetype_reserve(&_Game.actionChunks));
+  LS_ERROR_CHECK(movement_kinematics_add(&_Game.movementKinematics, index, pos));
 
-    pActor->atDestinationLastTick = pActor->atDestination; // Has to be at this position, as it otherwise wouldn't catch the value changing from the actor being on the right tile already but with a different target last tick. It's therefor completly useless for this function!
+  actor_archetype_add(&_Game.actionChunks, index, movement, ls_actor, actionActor);
 
-    const size_t currentTileIdx = worldPosToTileIndex(pActor->pos);
-    lsAssert(currentTileIdx != 0 && currentTileIdx < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+epilogue:
+  return result;
+}
 
-    if (pActor->isWaiting)
-    {
-      if (pActor->ticksToWait)
-        pActor->ticksToWait--;
-      else
-        pActor->isWaiting = false;
-    }
-    else
-    {
-      const level_info::resource_info &info = _Game.levelInfo.resources[pActor->target];
-      const direction currentTileDirectionType = info.pDirectionLookup[1 - info.write_direction_idx][currentTileIdx].dir;
+lsResult spawnActors(const size_t actorCounts[aT_count])
+{
+  lsResult result = lsR_Success;
 
-      lsAssert(pActor->pos.x > 0 && pActor->pos.x < _Game.levelInfo.map_size.x && pActor->pos.y > 0 && pActor->pos.y < _Game.levelInfo.map_size.y);
+  const vec2f FixedPositions[] = { vec2f((float_t)(4 % _Game.levelInfo.map_size.x), (float_t)(4 % _Game.levelInfo.map_size.y)), vec2f(10.f, 8.f), vec2f(12.f, 10.f), vec2f(13.f, 13.f) };
+  static_assert(LS_ARRAYSIZE(FixedPositions) == aT_count);
 
-      if (currentTileDirectionType == d_unreachable)
-      {
-        continue;
-      }
-      else if (currentTileDirectionType == d_atDestination)
-      {
-        pActor->atDestination = true;
-        pActor->direction = vec2f(0);
-        continue;
-      }
+  rand_seed seed = _Game.levelInfo.gameplaySeed;
+
+  for (size_t type = 0; type < aT_count; type++)
+  {
+    for (size_t i = 0; i < actorCounts[type]; i++)
+    {
+      vec2f pos = FixedPositions[type];
 
-      if (currentTileIdx != pActor->lastTickTileIdx)
+      if (i > 0)
       {
-        if (currentTileDirectionType == d_unfillable)
-        {
-          pActor->direction = (tileIndexToWorldPos(pActor->lastTickTileIdx) - pActor->pos).Normalize();
-        }
-        else
+        constexpr size_t MaxSpawnAttempts = 64;
+
+        for (size_t attempt = 0; attempt < MaxSpawnAttempts; attempt++)
         {
-          const vec2f tilePos = tileIndexToWorldPos(currentTileIdx);
-          const vec2f nonNormalizedDir = (tilePos - pActor->pos);
-          if (nonNormalizedDir != vec2f(0))
-            pActor->direction = nonNormalizedDir.Normalize();
+          pos = vec2f((float_t)(1 + lsGetRand(seed) % (_Game.levelInfo.map_size.x - 2)), (float_t)(1 + lsGetRand(seed) % (_Game.levelInfo.map_size.y - 2)));
 
-          pActor->enteredDifferentTileLastTick = true;
+          if (!(tile_target_mask(_Game.levelInfo.pGameplayMap[worldPosToTileIndex(pos)]) & CollidableTargetBit))
+            break;
         }
       }
-      else if (pActor->enteredDifferentTileLastTick)
-      {
-        const vec2f directionLut[6] = { vec2f(-0.5, 1), vec2f(-1, 0), vec2f(-0.5, -1), vec2f(0.5, -1), vec2f(1, 0), vec2f(0.5, 1) };
-        const vec2f tilePos = tileIndexToWorldPos(currentTileIdx);
-        const vec2f direction = directionLut[currentTileDirectionType - 1];
-        const vec2f destinationPos = tilePos + direction;
-
-        lsAssert(destinationPos - pActor->pos != vec2f(0));
-        pActor->direction = (destinationPos - pActor->pos).Normalize();
-        pActor->enteredDifferentTileLastTick = false;
-      }
 
-      pActor->pos += vec2f(0.1) * pActor->direction;
+      LS_ERROR_CHECK(spawnActor((actor_type)type, pos));
     }
-
-    pActor->lastTickTileIdx = currentTileIdx;
   }
-}
-
-//////////////////////////////////////////////////////////////////////////
-
-bool execute_action(const drop_off_action &actn, actor *pActor, const size_t tileIdx)
-{
-  gameplay_element *pElement = &_Game.levelInfo.pGameplayMap[tileIdx];
 
-  if (pElement->tileType != actn.destTileType)
-    return false;
+  movementActor_updateTileIndices();
 
-  // drop off
-  if (actn.destTileType == tT_market)
-    modify_with_clamp(pActor->inventory[actn.item], -add_to_market_tile(actn.item, actn.amount, tileIdx));
-  else
-    modify_with_clamp(pElement->resourceCount, modify_with_clamp(pActor->inventory[actn.item], -actn.amount), uint8_t(0), pElement->maxResourceCount);
+  _Game.levelInfo.gameplaySeed = seed;
 
-  return true;
+epilogue:
+  return result;
 }
 
-bool execute_action(const get_action &actn, actor *pActor, const size_t tileIdx)
+lsResult initializeLevel(const level_settings &settings)
 {
-  if (_Game.levelInfo.pGameplayMap[tileIdx].tileType != actn.item && _Game.levelInfo.pGameplayMap[tileIdx].tileType != tT_market)
-    return false;
+  lsResult result = lsR_Success;
 
-  uint8_t returnedAmount = get_from_tile(tileIdx, actn.item, actn.amount);
+  _Game.levelInfo.gameplaySeed = rand_seed(settings.seed, ~settings.seed);
 
-  //if (!returnedAmount)
-  //  return false;
+  LS_ERROR_CHECK(mapInit(settings.mapSize.x, settings.mapSize.y));
+  LS_ERROR_CHECK(setTerrain(settings.seed));
+  //LS_ERROR_CHECK(fillTerrain(tT_grass));
 
-  modify_with_clamp(pActor->inventory[actn.item], returnedAmount);
-  return true;
-}
+  list_clear(&_Game.levelInfo.tileChanges); // The initial fill already contains the generated terrain.
+  updateAllPassableNeighbors(); // The border and some fixed tiles are written directly.
+  _Game.levelInfo.tileComponentsDirty = true;
 
-bool execute_action(const change_tile_action &actn, actor *pActor, const size_t tileIdx)
-{
-  if (change_tile_to(actn.targetTileType, actn.currentTileType, tileIdx, actn.amount))
-    return true;
+  // Direction maps are allocated and filled once they're queried for the first time.
+  _Game.levelInfo.pathfindingLayout = _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y >= HierarchicalPathfindingMinTileCount ? pL_hierarchical : pL_flat;
 
-  return false;
+  LS_ERROR_CHECK(spawnActors(settings.actorCounts));
+  _Game.levelInfo.playerPos = vec2i16((int16_t)lsMin(_Game.levelInfo.map_size.x / 2, (size_t)lsMaxValue<int16_t>()), (int16_t)lsMin(_Game.levelInfo.map_size.y / 2, (size_t)lsMaxValue<int16_t>()));
+
+epilogue:
+  return result;
 }
 
 //////////////////////////////////////////////////////////////////////////
 
-template <typename T>
-  requires (std::is_integral_v<T> && (sizeof(T) < sizeof(int64_t) || std::is_same_v<T, int64_t>))
-inline T modify_with_clamp(T &value, const int64_t diff, const T min = lsMinValue<T>(), const T max = lsMaxValue<T>())
+#ifndef _DEBUG
+FORCEINLINE
+#endif
+void floodfill_suggestNextTarget(queue<fill_step> &pathfindQueue, direction_map &directionMap, const size_t nextIndex, const size_t nextStored, const direction dir, const uint32_t parentDist)
 {
-  const int64_t val = (int64_t)value + diff;
-  const T prevVal = value;
-  value = (T)lsClamp<int64_t>(val, min, max);
-  return (T)lsAbs((int64_t)value - prevVal);
+  if (direction_map_getDirStored(directionMap, nextStored) == d_unreachable)
+  {
+    const uint32_t dist = parentDist + 1;
+    direction_map_setStored(directionMap, nextStored, dir, dist);
+    queue_pushBack(&pathfindQueue, fill_step(nextIndex, dist)); // The queue carries the distance, so targets without a distance map still count correctly.
+  }
 }
 
-bool change_tile_to(const resource_type targetType, const resource_type expectedCurrentType, const size_t tileIdx, const uint8_t count)
+// Coordinate offsets of the neighbours in direction `dir - d_topRight`, matching `level_info::neighborOffsets` for even and odd rows.
+static constexpr int8_t NeighborDeltaX[2][6] = { { 0, 1, 0, -1, -1, -1 }, { 1, 1, 1, 0, -1, 0 } };
+static constexpr int8_t NeighborDeltaY[6] = { -1, 0, 1, 1, 0, -1 };
+
+// The layout is a template parameter, so row major fills don't branch per neighbour and chunked fills only divide once per popped tile.
+template <tile_storage_layout Layout>
+bool floodfill_layout(queue<fill_step> &pathfindQueue, direction_map &directionMap, const pathfinding_element *pPathfindingMap, const size_t maxSteps)
 {
-  // TODO: if we can conclude from the resource_type to the ptt we could add an assert, that the ptt is `at_dest` in the pathfindingMap to assert, that the `expectedType` isn't nonsense
+  constexpr direction SuggestionOrder[] = { d_left, d_right, d_bottomLeft, d_bottomRight, d_topLeft, d_topRight }; // bottomRight and bottomLeft are flipped to not give the right side all the paths
 
-  lsAssert(tileIdx >= 0 && tileIdx < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+  const size_t width = _Game.levelInfo.map_size.x;
 
-  if (_Game.levelInfo.pGameplayMap[tileIdx].tileType == expectedCurrentType)
+  fill_step current;
+  size_t stepCount = 0;
+
+  while (pathfindQueue.count)
   {
-    // TODO what free assert did coc talk about?
-    lsAssert(setGameplayTile(tileIdx, targetType, count) == lsR_Success);
-    return true;
+    if (stepCount >= maxSteps)
+      return false;
+
+    queue_popFront(&pathfindQueue, &current);
+    lsAssert(current.index >= 0 && current.index < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+
+    const uint8_t passableNeighbors = pPathfindingMap[current.index].passableNeighbors;
+    const size_t y = current.index / width;
+    const int64_t *pOffsets = _Game.levelInfo.neighborOffsets[y & 1];
+
+    if constexpr (Layout == tSL_rowMajor)
+    {
+      for (const direction dir : SuggestionOrder)
+      {
+        if (passableNeighbors & direction_bit(dir))
+        {
+          const size_t nextIndex = (size_t)((int64_t)current.index + pOffsets[dir - d_topRight]);
+          floodfill_suggestNextTarget(pathfindQueue, directionMap, nextIndex, nextIndex, dir, current.dist);
+        }
+      }
+    }
+    else
+    {
+      const size_t x = current.index - y * width;
+      const int8_t *pDeltaX = NeighborDeltaX[y & 1];
+
+      for (const direction dir : SuggestionOrder)
+        if (passableNeighbors & direction_bit(dir)) // Passable neighbours are never outside of the map.
+          floodfill_suggestNextTarget(pathfindQueue, directionMap, (size_t)((int64_t)current.index + pOffsets[dir - d_topRight]), tile_storage_indexAt<Layout>(directionMap.storage, (size_t)((int64_t)x + pDeltaX[dir - d_topRight]), (size_t)((int64_t)y + NeighborDeltaY[dir - d_topRight])), dir, current.dist);
+    }
+
+    stepCount++;
   }
 
-  return false;
+  // if queue is empty: floodfill completed
+  return true;
 }
 
-uint8_t add_to_market_tile(const resource_type resource, const int16_t amount, const size_t tileIdx)
+bool floodfill(queue<fill_step> &pathfindQueue, direction_map &directionMap, const pathfinding_element *pPathfindingMap, const size_t maxSteps)
 {
-  lsAssert(tileIdx >= 0 && tileIdx < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
-  lsAssert(resource < tT_count);
-
-  gameplay_element *pTile = &_Game.levelInfo.pGameplayMap[tileIdx];
-
-  lsAssert(pTile->tileType == tT_market);
-  lsAssert(pTile->multiResourceCountIndex > -1);
+  if (directionMap.storage.layout == tSL_chunked)
+    return floodfill_layout<tSL_chunked>(pathfindQueue, directionMap, pPathfindingMap, maxSteps);
+  else
+    return floodfill_layout<tSL_rowMajor>(pathfindQueue, directionMap, pPathfindingMap, maxSteps);
+}
 
-  local_list<uint8_t, tT_count> *pList = list_get(&_Game.levelInfo.multiResourceCounts, pTile->multiResourceCountIndex);
+//////////////////////////////////////////////////////////////////////////
 
-  return modify_with_clamp((*pList)[resource], amount);
+FORCEINLINE size_t wavefront_rowWordCount()
+{
+  return (_Game.levelInfo.map_size.x + 63) / 64;
 }
 
-uint8_t get_from_tile(const size_t tileIdx, const resource_type resource, const uint8_t amount)
+lsResult wavefront_updateElevationMasks()
 {
-  lsAssert(tileIdx >= 0 && tileIdx < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
-  lsAssert(resource < tT_count);
+  lsResult result = lsR_Success;
 
-  gameplay_element *pTile = &_Game.levelInfo.pGameplayMap[tileIdx];
+  const size_t rowWords = wavefront_rowWordCount();
+  const size_t maskWords = rowWords * _Game.levelInfo.map_size.y;
 
-  if (pTile->multiResourceCountIndex == -1)
+  size_t levelCount = 1;
+
+  for (size_t i = 0; i < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y; i++)
+    levelCount = lsMax(levelCount, (size_t)_Game.levelInfo.pPathfindingMap[i].elevationLevel + 1);
+
+  if (levelCount > _Game.levelInfo.elevationMaskLevelCount)
   {
-    lsAssert(pTile->tileType == resource);
-    if (pTile->maxResourceCount == 1)
-      return (uint8_t)1;
-    
-    return modify_with_clamp(pTile->resourceCount, -amount);
+    LS_ERROR_CHECK(lsRealloc(&_Game.levelInfo.pElevationMasks, levelCount * maskWords));
+    LS_ERROR_CHECK(lsRealloc(&_Game.levelInfo.pReachableMasks, levelCount * maskWords));
+    _Game.levelInfo.elevationMaskLevelCount = levelCount;
   }
-  else
+
+  lsZeroMemory(_Game.levelInfo.pElevationMasks, _Game.levelInfo.elevationMaskLevelCount * maskWords);
+
+  for (size_t y = 0; y < _Game.levelInfo.map_size.y; y++)
+    for (size_t x = 0; x < _Game.levelInfo.map_size.x; x++)
+      _Game.levelInfo.pElevationMasks[_Game.levelInfo.pPathfindingMap[y * _Game.levelInfo.map_size.x + x].elevationLevel * maskWords + y * rowWords + x / 64] |= (uint64_t)1 << (x & 63);
+
+  for (size_t level = 0; level < _Game.levelInfo.elevationMaskLevelCount; level++)
   {
-    lsAssert(pTile->tileType == tT_market);
-    local_list<uint8_t, tT_count> *pList = list_get(&_Game.levelInfo.multiResourceCounts, pTile->multiResourceCountIndex);
-    return modify_with_clamp(*local_list_get(pList, resource), -amount);
+    const uint64_t *pLevel = _Game.levelInfo.pElevationMasks + level * maskWords;
+    uint64_t *pReachable = _Game.levelInfo.pReachableMasks + level * maskWords;
+
+    for (size_t i = 0; i < maskWords; i++)
+      pReachable[i] = pLevel[i] | (level > 0 ? pLevel[i - maskWords] : 0) | (level + 1 < _Game.levelInfo.elevationMaskLevelCount ? pLevel[i + maskWords] : 0);
   }
+
+  _Game.levelInfo.elevationMasksDirty = false;
+
+epilogue:
+  return result;
 }
 
-//////////////////////////////////////////////////////////////////////////
+// Only fills that haven't expanded yet can be taken over, as the wavefront requires the whole frontier to share one distance.
+bool wavefront_canBegin(const level_info::resource_info &info)
+{
+  return !info.pathfinding_queue.count || (queue_getRef_unsafe(info.pathfinding_queue, 0).dist == 0 && queue_getRef_unsafe(info.pathfinding_queue, info.pathfinding_queue.count - 1).dist == 0);
+}
 
-void update_lifesupportActors()
+// Moves the seeds from the queue into the frontier bitset.
+lsResult wavefront_begin(level_info::resource_info &info, const direction_map &directionMap)
 {
-  static const uint8_t EatingThreshold = 3;
-  static const uint8_t AppetiteThreshold = 10;
-  static const uint8_t MaxNutritionValue = 255;
-  static const int64_t FoodItemGain = 16;
-  static const uint8_t MaxFoodItemCount = 255;
-  static const uint8_t MinFoodItemCount = 0;
+  lsResult result = lsR_Success;
 
-  static const uint8_t ColdThreshold = 10;
-  static const int64_t TemperatureIncrease = 255;
-  static const uint8_t MaxTemperature = 255;
+  wavefront_fill_state &state = info.wavefront;
+  const size_t rowWords = wavefront_rowWordCount();
+  const size_t maskWords = rowWords * _Game.levelInfo.map_size.y;
 
-  static const size_t nutritionTypeCount = (_ptT_nutrient_last + 1) - _ptT_nutrient_first;
-  static const size_t foodTypeCount = (_tile_type_food_last + 1) - _tile_type_food_first;
-  static const int64_t FoodToNutrition[foodTypeCount][nutritionTypeCount] = { { 50, 0, 0, 0 } /*tomato*/, {0, 50, 0, 0} /*bean*/, { 0, 0, 50, 0 } /*wheat*/,  { 0, 0, 0, 50 } /*sunflower*/, {25, 25, 25, 25} /*meal*/ }; // foodtypes and nutrition value need to be in the same order as the corresponding enums!
+  lsAssert(!state.active);
 
-  for (auto _actor : _Game.lifesupportActors)
-  {
-    lifesupport_actor *pLifeSupport = _actor.pItem;
-    movement_actor *pActor = pool_get(_Game.movementActors, pLifeSupport->entityIndex);
+  if (state.pFrontier == nullptr)
+    LS_ERROR_CHECK(lsAllocZero(&state.pFrontier, maskWords));
 
-    if (pActor->isWaiting) // We won't loose any nutrients or 
-      continue;
+  if (state.pNextFrontier == nullptr)
+    LS_ERROR_CHECK(lsAllocZero(&state.pNextFrontier, maskWords));
 
-    // TODO think about actual system to nutrition and temperature usage
-    // just for testing!!!!
-    if (_Game.levelInfo.isNight)
-    {
-      modify_with_clamp(pLifeSupport->temperature, (int16_t)(-1));
-    }
-    else
-    {
-      for (size_t j = 0; j < nutritionTypeCount; j++)
-        modify_with_clamp(pLifeSupport->nutritions[j], (int16_t)-1, (uint8_t)0, MaxNutritionValue);
-    }
+  if (state.pVisited == nullptr)
+    LS_ERROR_CHECK(lsAlloc(&state.pVisited, maskWords));
 
-    const size_t tileIdx = worldPosToTileIndex(pActor->pos);
-    const level_info::resource_info &nfo = _Game.levelInfo.resources[pActor->target];
+  if (state.pParentRows == nullptr)
+    LS_ERROR_CHECK(lsAllocZero(&state.pParentRows, 3 * (rowWords + 2))); // The padding words are never written.
 
-    if (!pActor->survivalActorActive || nfo.pDirectionLookup[1 - nfo.write_direction_idx][tileIdx].dir == d_unreachable) // Resetting the target in case the food is currently unreachable (actors will still be stuck if there is no food at all, but won't be stuck if there is *some* food, just not the one their target is set to.
-    {
-      if (_Game.levelInfo.isNight)
-      {
-        if (pLifeSupport->type != aT_fire_actor && pLifeSupport->temperature < ColdThreshold)
-        {
-          pActor->survivalActorActive = true;
-          pActor->target = ptT_fire;
-          pActor->atDestination = false;
-        }
-      }
-      else
-      {
-        bool anyNeededNutrion = false;
+  lsZeroMemory(state.pVisited, maskWords);
 
-        for (size_t j = 0; j < nutritionTypeCount; j++)
-        {
-          if (pLifeSupport->nutritions[j] < EatingThreshold)
-          {
-            anyNeededNutrion = true;
-            break;
-          }
-        }
+  state.frontierFirstRow = _Game.levelInfo.map_size.y;
+  state.frontierLastRow = 0;
 
-        if (anyNeededNutrion)
-        {
-          int8_t bestScore = 0;
-          size_t bestIndex = 0;
+  // Targets and unfillable tiles are never entered.
+  for (size_t y = 0; y < _Game.levelInfo.map_size.y; y++)
+    for (size_t x = 0; x < _Game.levelInfo.map_size.x; x++)
+      if (direction_map_getDir(directionMap, y * _Game.levelInfo.map_size.x + x) != d_unreachable)
+        state.pVisited[y * rowWords + x / 64] |= (uint64_t)1 << (x & 63);
 
-          for (size_t i = 0; i < LS_ARRAYSIZE(pLifeSupport->lunchbox); i++)
-          {
-            if (pLifeSupport->lunchbox[i])
-            {
-              int8_t score = 0;
-
-              for (size_t j = 0; j < nutritionTypeCount; j++)
-                if (FoodToNutrition[i][j] > 0)
-                  score += pLifeSupport->nutritions[j] < AppetiteThreshold ? nutritionTypeCount : -1;
-
-              if (score > bestScore)
-              {
-                bestScore = score;
-                bestIndex = i;
-              }
-            }
-          }
+  {
+    fill_step seed;
 
-          // eat best item
-          if (bestScore > 0)
-          {
-            for (size_t j = 0; j < nutritionTypeCount; j++)
-              modify_with_clamp(pLifeSupport->nutritions[j], FoodToNutrition[bestIndex][j], MinFoodItemCount, MaxFoodItemCount);
+    while (info.pathfinding_queue.count)
+    {
+      queue_popFront(&info.pathfinding_queue, &seed);
+      lsAssert(seed.dist == 0);
 
-            // remove from lunchbox
-            modify_with_clamp(pLifeSupport->lunchbox[bestIndex], (int64_t)-1, MinFoodItemCount, MaxFoodItemCount);
+      const size_t x = seed.index % _Game.levelInfo.map_size.x;
+      const size_t y = seed.index / _Game.levelInfo.map_size.x;
 
-            lsAssert(!pActor->isWaiting); // we need to eat after waiting else we just are hungry again. or dont eat when waiting?
-            pActor->isWaiting = true;
-            pActor->ticksToWait = 20;
-          }
-          else // if no item: set actor target
-          {
-            pathfinding_target_type lowestNutrient = ptT_Count;
+      state.pFrontier[y * rowWords + x / 64] |= (uint64_t)1 << (x & 63);
+      state.frontierFirstRow = lsMin(state.frontierFirstRow, y);
+      state.frontierLastRow = lsMax(state.frontierLastRow, y);
+    }
+  }
+
+  state.dist = 0;
+  state.active = true;
 
-            int64_t bestTargetScore = -1;
-            const int64_t maxDist = (int64_t)(_Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+epilogue:
+  return result;
+}
 
-            for (size_t j = 0; j < nutritionTypeCount; j++)
-            {
-              const pathfinding_target_type nutrient = (pathfinding_target_type)(j + _ptT_nutrient_first);
+// Expands the whole frontier by one layer. Returns false if there was nothing left to expand.
+bool wavefront_expandLayer(wavefront_fill_state &state, direction_map &directionMap, size_t *pStepCount)
+{
+  if (state.frontierFirstRow > state.frontierLastRow)
+    return false;
 
-              const uint8_t value = pLifeSupport->nutritions[j];
-              int64_t score = value < EatingThreshold ? lsMaxValue<int16_t>() : MaxNutritionValue - value;
+  const size_t height = _Game.levelInfo.map_size.y;
+  const size_t rowWords = wavefront_rowWordCount();
+  const size_t maskWords = rowWords * height;
+  const uint32_t nextDist = state.dist + 1;
 
-              const level_info::resource_info &info = _Game.levelInfo.resources[nutrient];
-              const pathfinding_info pathInfo = info.pDirectionLookup[1 - info.write_direction_idx][tileIdx];
+  const size_t firstRow = state.frontierFirstRow > 0 ? state.frontierFirstRow - 1 : 0;
+  const size_t lastRow = lsMin(state.frontierLastRow + 1, height - 1);
 
-              if (pathInfo.dir != d_unreachable && value < EatingThreshold)
-                score += maxDist - pathInfo.dist;
+  size_t nextFirstRow = height;
+  size_t nextLastRow = 0;
 
-              if (score > bestTargetScore)
-              {
-                bestTargetScore = score;
-                lowestNutrient = nutrient;
-              }
-            }
+  for (size_t y = firstRow; y <= lastRow; y++)
+  {
+    uint64_t *pVisitedRow = state.pVisited + y * rowWords;
+    uint64_t *pNextRow = state.pNextFrontier + y * rowWords;
+    const bool verticalParentsOdd = !(y & 1); // The rows above and below share their parity.
 
-            lsAssert(bestTargetScore > -1 && lowestNutrient <= _ptT_nutrient_last);
+    for (size_t level = 0; level < _Game.levelInfo.elevationMaskLevelCount; level++)
+    {
+      const uint64_t *pLevelRow = _Game.levelInfo.pElevationMasks + level * maskWords + y * rowWords;
+      const uint64_t *pReachable = _Game.levelInfo.pReachableMasks + level * maskWords;
+      *pStepCount += rowWords;
 
-            const level_info::resource_info &info = _Game.levelInfo.resources[lowestNutrient];
-            if ((pLifeSupport->type == aT_farmer || pLifeSupport->type == aT_cook) && info.pDirectionLookup[1 - info.write_direction_idx][tileIdx].dir == d_unreachable)
-              continue;
+      // Frontier tiles of the rows above, at and below `y` that can step onto a tile of `level` (none outside of the map).
+      // Every row has a zero word before and after it, so the carries across word boundaries don't need bounds checks.
+      const uint64_t *pParentRows[3];
 
-            pActor->survivalActorActive = true;
-            pActor->target = lowestNutrient;
-            pActor->atDestination = false;
-          }
+      for (size_t r = 0; r < LS_ARRAYSIZE(pParentRows); r++)
+      {
+        uint64_t *pParentRow = state.pParentRows + r * (rowWords + 2) + 1;
+        pParentRows[r] = pParentRow;
+
+        const size_t row = y + r - 1; // Wraps around above the first row.
+
+        if (row >= height)
+        {
+          lsZeroMemory(pParentRow, rowWords);
+          continue;
         }
+
+        for (size_t i = 0; i < rowWords; i++)
+          pParentRow[i] = state.pFrontier[row * rowWords + i] & pReachable[row * rowWords + i];
       }
-    }
-    else
-    {
-      if (pActor->atDestination)
+
+      const uint64_t *pAbove = pParentRows[0];
+      const uint64_t *pSame = pParentRows[1];
+      const uint64_t *pBelow = pParentRows[2];
+
+      for (size_t i = 0; i < rowWords; i++)
       {
-        if (pActor->target >= _ptT_nutrient_first && pActor->target <= _ptT_nutrient_last)
-        {
-          // add food to lunchbox
-          if (_Game.levelInfo.pGameplayMap[tileIdx].tileType >= _tile_type_food_first && _Game.levelInfo.pGameplayMap[tileIdx].tileType <= _tile_type_food_last && _Game.levelInfo.pGameplayMap[tileIdx].resourceCount > 0) // check if this was ok? it sure didn't fix the issue that the farmer is stuck on empty food tiles...
-          {
-            const resource_type tileType = _Game.levelInfo.pGameplayMap[tileIdx].tileType;
-            lsAssert(tileType - _tile_type_food_first >= 0 && tileType - _tile_type_food_first <= _tile_type_food_last);
-            modify_with_clamp(pLifeSupport->lunchbox[tileType - _tile_type_food_first], FoodItemGain, MinFoodItemCount, MaxFoodItemCount);
+        uint64_t remaining = pLevelRow[i] & ~pVisitedRow[i];
 
-            modify_with_clamp(_Game.levelInfo.pGameplayMap[tileIdx].resourceCount, -FoodItemGain);
+        if (!remaining)
+          continue;
 
-            //if (_Game.levelInfo.pGameplayMap[tileIdx].resourceCount == 0)
-            //  _Game.levelInfo.pGameplayMap[tileIdx] = gameplay_element(tT_grass, 1); // no `change_tile_to` usage because we check earlier
-          }
-          else
-          {
-            pActor->atDestination = false;
-          }
-        }
-        else if (pActor->target == ptT_fire)
+        const uint64_t same = pSame[i];
+        const uint64_t above = pAbove[i];
+        const uint64_t below = pBelow[i];
+
+        // Parent x + 1 / parent x - 1, carrying across word boundaries.
+        const uint64_t sameLeft = (same >> 1) | (pSame[i + 1] << 63);
+        const uint64_t sameRight = (same << 1) | (pSame[i - 1] >> 63);
+        const uint64_t aboveLeft = (above >> 1) | (pAbove[i + 1] << 63);
+        const uint64_t aboveRight = (above << 1) | (pAbove[i - 1] >> 63);
+        const uint64_t belowLeft = (below >> 1) | (pBelow[i + 1] << 63);
+        const uint64_t belowRight = (below << 1) | (pBelow[i - 1] >> 63);
+
+        // Children per direction that they were entered from, in the same order as `floodfill` suggests them.
+        const uint64_t children[] =
         {
-          // warm up at fire
-          if (_Game.levelInfo.pGameplayMap[tileIdx].tileType == tT_fire)
-          {
-            lsAssert(!pActor->isWaiting);
+          sameLeft, // d_left
+          sameRight, // d_right
+          verticalParentsOdd ? above : aboveLeft, // d_bottomLeft
+          verticalParentsOdd ? aboveRight : above, // d_bottomRight
+          verticalParentsOdd ? below : belowLeft, // d_topLeft
+          verticalParentsOdd ? belowRight : below, // d_topRight
+        };
+
+        constexpr direction ChildDirections[] = { d_left, d_right, d_bottomLeft, d_bottomRight, d_topLeft, d_topRight };
+        static_assert(LS_ARRAYSIZE(ChildDirections) == LS_ARRAYSIZE(children));
+
+        for (size_t d = 0; d < LS_ARRAYSIZE(ChildDirections) && remaining; d++)
+        {
+          const uint64_t found = children[d] & remaining;
 
-            if (!pActor->atDestinationLastTick)
-            {
-              pActor->isWaiting = true;
-              pActor->ticksToWait = 50;
-              continue;
-            }
+          if (!found)
+            continue;
 
-            if (_Game.levelInfo.pGameplayMap[tileIdx].resourceCount > 0)
-              modify_with_clamp(pLifeSupport->temperature, (int16_t)(200), (uint8_t)(0), MaxTemperature);
+          remaining &= ~found;
+          pNextRow[i] |= found;
+          pVisitedRow[i] |= found;
 
-            // for testing: remove from fire & remove fire when empty
-            lsAssert(_Game.levelInfo.pGameplayMap[tileIdx].resourceCount > 0);
-            _Game.levelInfo.pGameplayMap[tileIdx].resourceCount--;
+          for (uint64_t bits = found; bits; bits &= bits - 1)
+            direction_map_setStored(directionMap, tile_storage_indexAt(directionMap.storage, i * 64 + lsLowestBit(bits), y), ChildDirections[d], nextDist); // Coordinates are known here, so chunked maps don't have to divide.
+        }
 
-            if (_Game.levelInfo.pGameplayMap[tileIdx].resourceCount == 0)
-              _Game.levelInfo.pGameplayMap[tileIdx].tileType = tT_fire_pit; // No usage of `change_tile_to` because of check above. Actually okay to just change the tileType as we want to keep `count` and `maxResourceCount` between `tT_fire` and `tT_fire_pit` are the same.
-          }
-          else
-          {
-            pActor->atDestination = false;
-          }
+        if (pNextRow[i])
+        {
+          nextFirstRow = lsMin(nextFirstRow, y);
+          nextLastRow = lsMax(nextLastRow, y);
         }
       }
     }
   }
-}
 
-//////////////////////////////////////////////////////////////////////////
-
-bool resetAfterSurvival(movement_actor *pActor)
-{
-  lsAssert(!pActor->isWaiting); // Should be handled by the actors already
-
-  if (pActor->atDestination || (!_Game.levelInfo.isNight && pActor->target == ptT_fire))
-  {
-    pActor->survivalActorActive = false;
-    pActor->atDestination = false;
+  // The old frontier becomes the next `pNextFrontier`, which has to be empty.
+  lsZeroMemory(state.pFrontier + state.frontierFirstRow * rowWords, (state.frontierLastRow - state.frontierFirstRow + 1) * rowWords);
+  std::swap(state.pFrontier, state.pNextFrontier);
 
-    return true;
-  }
+  state.frontierFirstRow = nextFirstRow;
+  state.frontierLastRow = nextLastRow;
+  state.dist++;
 
-  return false;
+  return true;
 }
 
-//////////////////////////////////////////////////////////////////////////
+// Returns true once the fill completed, just like `floodfill`. Always expands at least one layer.
+bool wavefront_floodfill(level_info::resource_info &info, direction_map &directionMap, const size_t maxSteps)
+{
+  wavefront_fill_state &state = info.wavefront;
 
-// TODO: we could add ranges to operate in for the actors so they won't cross eachother's paths so much - well this does not quite work 1) because we can only ever have a range from where we currently are. 2) because actors need to go to fire/food further away. - only if the actors alwyas return to the one same place after everu step (but then every actor would need his own resource type...
+  if (!state.active && LS_FAILED(wavefront_begin(info, directionMap)))
+    return floodfill(info.pathfinding_queue, directionMap, _Game.levelInfo.pPathfindingMap, maxSteps); // Keep going with the queue if we're out of memory.
 
-// TODO: houses: add houses that conclude to several pathfindingtypes at once (e.g. a kitchen where all food drop offs and nutrient types are...). in a further step: render houses that can be bigger than just one tile.
+  size_t stepCount = 0;
 
-// TODO: I really want to let things grow slowly, or have actors wait for x amount of time until a task is finished.
-// we could have a state var for tiles (uint8) which e.g. indicates the grow state, the plant is only recognized for pathfinding, when there the state is the matchting number - else it is just `unfillable`...
-// i'm not quite sure how this one number is best representing different things, enums? e.g. a specific plant state could mean 'unwatered' but there could also be something like: 0-7 means different grow states, allthough for the game logic (not rendering) the specific grow state is probably irrelevant, its just that it didn't grow enough yet, but if we don't save a specific number, we would need to have one that represents the same elsewhere to know when it's ready to enter the fully grown state.
+  do
+  {
+    if (!wavefront_expandLayer(state, directionMap, &stepCount))
+    {
+      state.active = false;
+      return true;
+    }
+  } while (stepCount < maxSteps);
 
-// omg i don't know if i like that but i just had the idea (again? may be coc's idea) that an actor when not enough food, won't move anymore, but there could be helpers that provide first aid aka food (nvm they can't pathfind towards an actor (only if the actor turns the tile he stands on into something different?)
+  return false;
+}
 
-// I'm thinking I may want to simplify the actors and have every actor just do one or two tasks. like the lumberjack just planting trees and maybe watering them, whilst there is a woodworker which cuts and chops the wood. so the game is more about the right amount of actors? maybe I could simplify actors in general and make it much nicer to programm, as they just get generic interfaces.
+// Drops a fill in progress.
+void wavefront_reset(wavefront_fill_state &state)
+{
+  if (!state.active)
+    return;
 
-static constexpr pathfinding_target_type Lumberjack_TargetFromState[laS_count] = { ptT_soil, ptT_water, ptT_sapling, ptT_tree, ptT_trunk, ptT_market };
+  if (state.frontierFirstRow <= state.frontierLastRow)
+    lsZeroMemory(state.pFrontier + state.frontierFirstRow * wavefront_rowWordCount(), (state.frontierLastRow - state.frontierFirstRow + 1) * wavefront_rowWordCount());
 
-void incrementLumberjackState(lumberjack_actor *pLumberjack, movement_actor *pActor)
-{
-  pLumberjack->state = (lumberjack_actor_state)((pLumberjack->state + 1) % laS_count);
-  pActor->target = Lumberjack_TargetFromState[pLumberjack->state];
+  state.active = false;
 }
 
-void update_lumberjack()
+lsResult game_setPathfindingEngine(const pathfinding_fill_engine engine)
 {
-  for (const auto _actor : _LumberjackActors)
-  {
-    lumberjack_actor *pLumberjack = _actor.pItem;
-    movement_actor *pActor = pool_get(_Game.movementActors, pLumberjack->index);
+  lsResult result = lsR_Success;
 
-    if (pActor->isWaiting)
-      continue;
+  if (engine == pFE_queue)
+  {
+    // Hand unfinished wavefront fills over to the queue. All frontier tiles share the same distance, so this is a valid BFS queue.
+    const size_t rowWords = wavefront_rowWordCount();
 
-    // Handle Survival
-    if (pActor->survivalActorActive)
+    for (size_t i = 0; i < ptT_Count - 1; i++) // Skip ptT_collidable
     {
-      if (resetAfterSurvival(pActor))
-        pActor->target = Lumberjack_TargetFromState[pLumberjack->state];
+      level_info::resource_info &info = _Game.levelInfo.resources[i];
+      wavefront_fill_state &state = info.wavefront;
 
-      continue; // maybe the continue needs to be inside the if above, that's where it was before, but I don't know if there's a reason for it and I needed the continue to be executed when the survival actor is active and waiting.
-    }
+      if (!state.active)
+        continue;
 
-    if (pActor->atDestination)
-    {
-      const size_t tileIdx = worldPosToTileIndex(pActor->pos);
+      size_t frontierCount = 0;
 
-      switch (pLumberjack->state)
-      {
-      case laS_plant:
-      {
-        if (change_tile_to(tT_sapling, tT_soil, tileIdx, MaxResourceCounts[tT_sapling]))
-          incrementLumberjackState(pLumberjack, pActor);
+      for (size_t y = state.frontierFirstRow; y <= state.frontierLastRow; y++)
+        for (size_t w = 0; w < rowWords; w++)
+          for (uint64_t bits = state.pFrontier[y * rowWords + w]; bits; bits &= bits - 1)
+            frontierCount++;
 
-        pActor->atDestination = false;
+      LS_ERROR_CHECK(queue_reserve(&info.pathfinding_queue, info.pathfinding_queue.count + frontierCount));
 
-        break;
-      }
-      case laS_getWater:
+      for (size_t y = state.frontierFirstRow; y <= state.frontierLastRow; y++)
       {
-        if (_Game.levelInfo.pGameplayMap[tileIdx].tileType == tT_water && _Game.levelInfo.pGameplayMap[tileIdx].resourceCount > 0)
+        for (size_t w = 0; w < rowWords; w++)
         {
-          lsAssert(!pLumberjack->hasItem);
+          for (uint64_t bits = state.pFrontier[y * rowWords + w]; bits; bits &= bits - 1)
+            queue_pushBack(&info.pathfinding_queue, fill_step(y * _Game.levelInfo.map_size.x + w * 64 + lsLowestBit(bits), state.dist));
 
-          pLumberjack->hasItem = true;
-          pLumberjack->item = tT_water;
-
-          incrementLumberjackState(pLumberjack, pActor);
+          state.pFrontier[y * rowWords + w] = 0;
         }
+      }
 
-        pActor->atDestination = false;
+      state.active = false;
+    }
+  }
 
-        break;
-      }
-      case laS_water:
-      {
-        lsAssert(pLumberjack->hasItem && pLumberjack->item == tT_water);
+  _Game.levelInfo.fillEngine = engine;
 
-        if (change_tile_to(tT_tree, tT_sapling, tileIdx, MaxResourceCounts[tT_tree]))
-        {
-          pLumberjack->hasItem = false;
-          incrementLumberjackState(pLumberjack, pActor);
-        }
+epilogue:
+  return result;
+}
 
-        pActor->atDestination = false;
+FORCEINLINE direction direction_opposite(const direction dir)
+{
+  lsAssert(dir >= d_topRight && dir <= d_topLeft);
+  return (direction)((dir - d_topRight + 3) % 6 + d_topRight);
+}
 
-        break;
-      }
-      case laS_chop:
-      {
-        if (change_tile_to(tT_trunk, tT_tree, tileIdx, MaxResourceCounts[tT_trunk]))
-          incrementLumberjackState(pLumberjack, pActor);
+// Marks `index` and every tile whose path leads through it as `d_unreachable`.
+lsResult repair_invalidateSubtree(level_info::resource_info &info, direction_map &directionMap, const size_t index)
+{
+  lsResult result = lsR_Success;
 
-        pActor->atDestination = false;
+  size_t i = info.repairInvalidated.count;
+  LS_ERROR_CHECK(list_add(&info.repairInvalidated, (uint32_t)index));
 
-        break;
-      }
-      case laS_cut:
+  for (; i < info.repairInvalidated.count; i++)
+  {
+    const size_t current = info.repairInvalidated.pValues[i];
+
+    // The stored direction points from the parent to the child, so children are the neighbours that were entered in exactly that direction.
+    for (uint8_t d = d_topRight; d <= d_topLeft; d++)
+    {
+      const size_t child = tileNeighbor(current, (direction)d);
+
+      if (direction_map_getDir(directionMap, child) == d)
       {
-        lsAssert(!pLumberjack->hasItem);
+        direction_map_setDir(directionMap, child, d_unreachable);
+        LS_ERROR_CHECK(list_add(&info.repairInvalidated, (uint32_t)child));
+      }
+    }
 
-        if (!pActor->atDestinationLastTick)
-        {
-          pActor->isWaiting = true;
-          pActor->ticksToWait = 100;
+    direction_map_setDir(directionMap, current, d_unreachable);
+  }
 
-          break;
-        }
+epilogue:
+  return result;
+}
 
-        if (change_tile_to(tT_soil, tT_trunk, tileIdx, MaxResourceCounts[tT_soil]))
-        {
-          pLumberjack->hasItem = true;
-          pLumberjack->item = tT_wood;
-          incrementLumberjackState(pLumberjack, pActor);
-        }
+// Applies all pending `tileChanges` to the read direction map of a completed field.
+// Tiles whose path got worse are invalidated and refilled from the remaining valid tiles around them, improvements (e.g. a new target) are propagated outwards until they no longer shorten any path.
+lsResult repair_resource_info(level_info::resource_info &info, const pathfinding_target_type type)
+{
+  lsResult result = lsR_Success;
 
-        pActor->atDestination = false;
+  direction_map &directionMap = info.directionMaps[1 - info.write_direction_idx];
+  queue<fill_step> &repairQueue = info.pathfinding_queue;
 
-        break;
-      }
-      case laS_drop_off:
-      {
-        lsAssert(pLumberjack->hasItem && pLumberjack->item == tT_wood);
+  lsAssert(info.fieldComplete);
+  lsAssert(directionMap.pDistances != nullptr); // Repairs compare distances, see `target_stores_distances`.
+  lsAssert(!repairQueue.count);
 
-        if (_Game.levelInfo.pGameplayMap[tileIdx].tileType == tT_market)
-        {
-          add_to_market_tile(tT_wood, 4, tileIdx);
-          pLumberjack->hasItem = false;
+  list_clear(&info.repairInvalidated);
 
-          incrementLumberjackState(pLumberjack, pActor);
-        }
+  for (size_t i = info.processedChangeCount; i < _Game.levelInfo.tileChanges.count; i++)
+  {
+    const tile_change change = _Game.levelInfo.tileChanges.pValues[i];
 
-        pActor->atDestination = false;
+    if (!(change.affectedTargets & ((target_mask)1 << type))) // Neither the paths through the tile nor whether it's a target changed.
+      continue;
 
-        break;
-      }
+    const gameplay_element &e = _Game.levelInfo.pGameplayMap[change.tileIndex];
+    const direction previous = direction_map_getDir(directionMap, change.tileIndex);
+    const target_mask mask = tile_target_mask(e);
+    const bool isTarget = !!(mask & ((target_mask)1 << type));
+    const bool isCollidable = !isTarget && (mask & CollidableTargetBit);
 
-      default:
-      {
-        lsFail(); // not implemented.
-      }
-      }
+    if (!change.passabilityChanged && (previous == d_atDestination) == isTarget && (previous == d_unfillable) == isCollidable)
+      continue;
+
+    // Paths through this tile might have gotten longer or disappeared entirely.
+    if (previous != d_unfillable && (change.passabilityChanged || isCollidable || (previous == d_atDestination && !isTarget)))
+      LS_ERROR_CHECK(repair_invalidateSubtree(info, directionMap, change.tileIndex));
+
+    if (isTarget)
+    {
+      direction_map_set(directionMap, change.tileIndex, d_atDestination, 0);
+      LS_ERROR_CHECK(queue_pushBack(&repairQueue, fill_step(change.tileIndex, 0)));
+    }
+    else if (isCollidable)
+    {
+      direction_map_setDir(directionMap, change.tileIndex, d_unfillable);
+    }
+    else if (previous == d_unfillable)
+    {
+      direction_map_setDir(directionMap, change.tileIndex, d_unreachable);
+      LS_ERROR_CHECK(list_add(&info.repairInvalidated, change.tileIndex));
     }
   }
-}
 
-///////////////////////////////////////////////////////////////////////////////////////////
+  info.processedChangeCount = _Game.levelInfo.tileChanges.count;
 
-void update_farmer()
-{
-  for (const auto _actor : _FarmerActors)
+  // Refill invalidated tiles from the valid tiles bordering them.
+  for (const uint32_t index : info.repairInvalidated)
   {
-    farmer_actor *pFarmer = _actor.pItem;
-    movement_actor *pActor = pool_get(_Game.movementActors, pFarmer->index);
-
-    if (pActor->isWaiting)
+    if (direction_map_getDir(directionMap, index) != d_unreachable)
       continue;
 
-    // Handle Survival
-    if (pActor->survivalActorActive)
+    for (uint8_t d = d_topRight; d <= d_topLeft; d++)
     {
-      if (resetAfterSurvival(pActor))
-        pActor->target = ptT_soil;
+      const size_t neighbor = tileNeighbor(index, (direction)d);
+      const direction neighborDir = direction_map_getDir(directionMap, neighbor);
 
-      continue;
+      if (neighborDir != d_unreachable && neighborDir != d_unfillable && tile_passableTowards(index, (direction)d))
+        LS_ERROR_CHECK(queue_pushBack(&repairQueue, fill_step(neighbor, direction_map_getDist(directionMap, neighbor))));
     }
+  }
 
-    if (pActor->atDestination)
-    {
-      const size_t tileIdx = worldPosToTileIndex(pActor->pos);
+  // Seeds don't share a distance, so tiles may be reached more than once until they settle on their shortest path.
+  {
+    fill_step current;
 
-      if (_Game.levelInfo.pGameplayMap[tileIdx].tileType == tT_soil)
-      {
-        pathfinding_target_type plant = ptT_Count;
+    while (repairQueue.count)
+    {
+      queue_popFront(&repairQueue, &current);
 
-        for (uint8_t i = _ptT_nutrient_sources_first; i <= _ptT_nutrient_sources_last; i++)
-        {
-          const level_info::resource_info &info = _Game.levelInfo.resources[i];
+      const direction currentDir = direction_map_getDir(directionMap, current.index);
 
-          if (info.pDirectionLookup[1 - info.write_direction_idx][tileIdx].dir == d_unreachable)
-          {
-            plant = (pathfinding_target_type)i; // TODO: Maybe we want to just increment the last plant and if its already there we choose another one that isn't
-            break;
-          }
-        }
+      if (currentDir == d_unreachable || currentDir == d_unfillable || direction_map_getDist(directionMap, current.index) < current.dist) // Outdated step.
+        continue;
 
-        if (plant == ptT_Count)
-          plant = (pathfinding_target_type)(lsGetRand() % (_ptT_nutrient_sources_last - _ptT_nutrient_sources_first) + _ptT_nutrient_sources_first);
+      const uint32_t nextDist = current.dist + 1;
 
-        constexpr uint8_t AddedAmountToPlant = 12;
+      for (uint8_t d = d_topRight; d <= d_topLeft; d++)
+      {
+        const size_t nextIndex = tileNeighbor(current.index, (direction)d);
+        const direction nextDir = direction_map_getDir(directionMap, nextIndex);
 
-        resource_type resource = (resource_type)plant;
-        lsAssert(resource >= _tile_type_food_resources_first && resource <= _tile_type_food_resources_last);
-        change_tile_to(resource, tT_soil, tileIdx, AddedAmountToPlant); // no `if` as we check above.
+        if (nextDir == d_unfillable || nextDir == d_atDestination || (nextDir != d_unreachable && direction_map_getDist(directionMap, nextIndex) <= nextDist) || !tile_passableTowards(current.index, (direction)d))
+          continue;
 
-        pActor->atDestination = false;
+        direction_map_set(directionMap, nextIndex, (direction)d, nextDist);
+        LS_ERROR_CHECK(queue_pushBack(&repairQueue, fill_step(nextIndex, nextDist)));
       }
     }
   }
+
+  info.readSeedChangeTotal = info.changeTotal;
+
+epilogue:
+  return result;
 }
 
-///////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
 
-resource_type getNextCookItem(const resource_type currentItem, const size_t tileIdx)
-{
-  resource_type ret = currentItem;
+constexpr uint32_t UnreachableNodeDistance = (uint32_t)-1;
+constexpr uint16_t UnreachedClusterDistance = (uint16_t)-1;
+constexpr size_t ClusterTileCount = PathfindingClusterSize * PathfindingClusterSize;
 
-  for (size_t i = _tile_type_food_first; i <= _tile_type_food_last; i++)
-  {
-    lsAssert(ret >= _tile_type_food_first && ret <= _tile_type_food_last);
-    ret = (resource_type)((((ret - _tile_type_food_first) + 1) % (_tile_type_food_last + 1 - _tile_type_food_first)) + _tile_type_food_first);
+static_assert(ClusterTileCount < UnreachedClusterDistance);
 
-    const level_info::resource_info &info = _Game.levelInfo.resources[(pathfinding_target_type)((ret - _tile_type_food_first) + _ptT_drop_off_first)];
-    const direction d = info.pDirectionLookup[1 - info.write_direction_idx][tileIdx].dir;
-    // check if there is a drop off for the item so we don't get stuck. (Maybe remove in the future, if we *want* actors to be stuck, when the right tiles weren't provided)
-    if (d != d_unreachable && d != d_unfillable)
-      break;
-  }
+struct cluster_bounds
+{
+  size_t x0, y0, width, height;
+};
 
-  return ret;
+FORCEINLINE size_t hierarchy_clusterCountX()
+{
+  return (_Game.levelInfo.map_size.x + PathfindingClusterSize - 1) / PathfindingClusterSize;
 }
 
-void update_cook()
+FORCEINLINE size_t hierarchy_clusterCount()
 {
-  constexpr uint8_t IngridientAmountPerFood[(_tile_type_food_last + 1) - _tile_type_food_first][(_ptT_nutrient_last + 1) - _ptT_nutrient_first] =
-  { // nutrients: ptT_vitamin, ptT_protein, ptT_carbohydrates, ptT_fat
-    { 1, 0, 0, 0 }, // tT_tomato
-    { 0, 1, 0, 0 }, // tT_bean
-    { 0, 0, 1, 0 }, // tT_wheat
-    { 0, 0, 0, 1 }, // tT_sunflower
-    { 1, 1, 1, 1 } // tT_meal
-  };
+  return hierarchy_clusterCountX() * ((_Game.levelInfo.map_size.y + PathfindingClusterSize - 1) / PathfindingClusterSize);
+}
 
-  for (const auto _actor : _CookActors)
-  {
-    cook_actor *pCook = _actor.pItem;
-    movement_actor *pActor = pool_get(_Game.movementActors, pCook->index);
+FORCEINLINE size_t hierarchy_clusterBitsetWords()
+{
+  return (hierarchy_clusterCount() + 63) / 64;
+}
 
-    if (pActor->isWaiting)
-      continue;
+FORCEINLINE size_t hierarchy_tileCluster(const size_t tileIndex)
+{
+  const size_t x = tileIndex % _Game.levelInfo.map_size.x;
+  const size_t y = tileIndex / _Game.levelInfo.map_size.x;
 
-    // Handle Survival
-    if (pActor->survivalActorActive)
-    {
-      if (resetAfterSurvival(pActor))
-        pCook->state = caS_check_inventory;
+  return (y / PathfindingClusterSize) * hierarchy_clusterCountX() + x / PathfindingClusterSize;
+}
 
-      continue;
-    }
+FORCEINLINE cluster_bounds hierarchy_clusterBounds(const size_t cluster)
+{
+  cluster_bounds bounds;
+  bounds.x0 = (cluster % hierarchy_clusterCountX()) * PathfindingClusterSize;
+  bounds.y0 = (cluster / hierarchy_clusterCountX()) * PathfindingClusterSize;
+  bounds.width = lsMin(PathfindingClusterSize, _Game.levelInfo.map_size.x - bounds.x0);
+  bounds.height = lsMin(PathfindingClusterSize, _Game.levelInfo.map_size.y - bounds.y0);
 
-    lsAssert(pCook->currentCookingItem >= _tile_type_food_first && pCook->currentCookingItem <= _tile_type_food_last);
+  return bounds;
+}
 
-    // Handle Cook States
-    const size_t tileIdx = worldPosToTileIndex(pActor->pos);
+// Index into the per cluster scratch arrays, `ClusterTileCount` if the tile isn't part of the cluster.
+FORCEINLINE size_t hierarchy_localIndex(const cluster_bounds &bounds, const size_t tileIndex)
+{
+  const size_t x = tileIndex % _Game.levelInfo.map_size.x;
+  const size_t y = tileIndex / _Game.levelInfo.map_size.x;
 
-    if (pCook->state == caS_check_inventory) // Handling `caS_check_inventory` here because it does not need to be checked for `atDestination`
-    {
-      bool anyItemMissing = false;
+  if (x < bounds.x0 || x >= bounds.x0 + bounds.width || y < bounds.y0 || y >= bounds.y0 + bounds.height)
+    return ClusterTileCount;
 
-      for (size_t i = 0; i < LS_ARRAYSIZE(pCook->inventory); i++)
-      {
-        if (pCook->inventory[i] <= 0 && IngridientAmountPerFood[pCook->currentCookingItem - _tile_type_food_first][i] > 0)
-        {
-          anyItemMissing = true;
+  return (y - bounds.y0) * PathfindingClusterSize + (x - bounds.x0);
+}
 
-          pathfinding_target_type targetPlant = (pathfinding_target_type)(i + _ptT_nutrient_sources_first);
+FORCEINLINE size_t hierarchy_tileIndex(const cluster_bounds &bounds, const size_t localIndex)
+{
+  return (bounds.y0 + localIndex / PathfindingClusterSize) * _Game.levelInfo.map_size.x + bounds.x0 + localIndex % PathfindingClusterSize;
+}
 
-          const level_info::resource_info &info = _Game.levelInfo.resources[targetPlant];
-          const direction targetPlantDir = info.pDirectionLookup[1 - info.write_direction_idx][tileIdx].dir;
+FORCEINLINE bool hierarchy_walkable(const size_t tileIndex)
+{
+  return !(_Game.levelInfo.pathfindingHierarchy.pTileTargets[tileIndex] & CollidableTargetBit);
+}
 
-          if (targetPlantDir != d_unfillable && targetPlantDir != d_unreachable)
-          {
-            pCook->state = caS_harvest;
-            pActor->target = targetPlant;
-            pActor->atDestination = false;
+FORCEINLINE bool hierarchy_bitsetContains(const uint64_t *pBitset, const size_t index)
+{
+  return !!(pBitset[index / 64] & ((uint64_t)1 << (index & 63)));
+}
 
-            break;
-          }
+FORCEINLINE void hierarchy_bitsetAdd(uint64_t *pBitset, const size_t index)
+{
+  pBitset[index / 64] |= (uint64_t)1 << (index & 63);
+}
 
-          continue;
-        }
-      }
+FORCEINLINE void hierarchy_bitsetRemove(uint64_t *pBitset, const size_t index)
+{
+  pBitset[index / 64] &= ~((uint64_t)1 << (index & 63));
+}
 
-      if (anyItemMissing && pCook->state == caS_check_inventory) // if none of the required plants is available, set new target meal. (Maybe remove in the future, if we *want* actors to be stuck, when the right tiles weren't provided)
-      {
-        pCook->currentCookingItem = getNextCookItem(pCook->currentCookingItem, tileIdx);
-        continue;
-      }
-      else if (!anyItemMissing) // if all items in inventory
-      {
-        pCook->state = caS_cook;
-        const pathfinding_target_type targetNutrient = (pathfinding_target_type)(_ptT_drop_off_first + (pCook->currentCookingItem - _tile_type_food_first));
+// Direction that leads from `from` to its neighbour `to`.
+direction tileDirection(const size_t from, const size_t to)
+{
+  for (uint8_t d = d_topRight; d <= d_topLeft; d++)
+    if (tileNeighbor(from, (direction)d) == to)
+      return (direction)d;
 
-        lsAssert(targetNutrient >= _ptT_drop_off_first && targetNutrient <= _ptT_drop_off_last);
+  lsFail(); // not a neighbour.
+  return d_unreachable;
+}
 
-        pActor->target = targetNutrient;
-        pActor->atDestination = false;
-      }
+// Breadth first fill that doesn't leave the cluster, starting at all tiles with a distance of 0. Tiles that can't be reached keep `UnreachedClusterDistance`.
+void hierarchy_clusterFill(const cluster_bounds &bounds, uint16_t *pDist)
+{
+  uint16_t fillQueue[ClusterTileCount];
+  size_t first = 0;
+  size_t count = 0;
 
-      continue;
-    }
+  for (size_t i = 0; i < ClusterTileCount; i++)
+    if (pDist[i] == 0)
+      fillQueue[count++] = (uint16_t)i;
+
+  while (first < count)
+  {
+    const size_t local = fillQueue[first++];
+    const size_t index = hierarchy_tileIndex(bounds, local);
 
-    // Handling remaining Cook States
-    if (pActor->atDestination)
+    for (uint8_t d = d_topRight; d <= d_topLeft; d++)
     {
-      const level_info::resource_info &info = _Game.levelInfo.resources[pActor->target];
-      lsAssert(info.pDirectionLookup[1 - info.write_direction_idx][tileIdx].dir == d_atDestination);
+      const size_t neighbor = tileNeighbor(index, (direction)d);
+      const size_t neighborLocal = hierarchy_localIndex(bounds, neighbor);
 
-      switch (pCook->state)
-      {
-      case caS_check_inventory:
-      {
-        lsAssert(false); // Should've been handled above.
-        break;
-      }
+      if (neighborLocal == ClusterTileCount || pDist[neighborLocal] != UnreachedClusterDistance || !hierarchy_walkable(neighbor) || !tile_passableTowards(index, (direction)d))
+        continue;
 
-      case caS_harvest:
-      {
-        if (_Game.levelInfo.pGameplayMap[tileIdx].tileType >= _tile_type_food_resources_first && _Game.levelInfo.pGameplayMap[tileIdx].tileType <= _tile_type_food_resources_last)
-        {
-          lsAssert(pActor->target >= _ptT_nutrient_sources_first && pActor->target <= _ptT_nutrient_sources_last);
+      pDist[neighborLocal] = pDist[local] + 1;
+      fillQueue[count++] = (uint16_t)neighborLocal;
+    }
+  }
+}
 
-          // check if plant has items left
-          if (_Game.levelInfo.pGameplayMap[tileIdx].resourceCount > 0)
-          {
-            // take item
-            constexpr int16_t AddedResourceAmount = 4;
-            modify_with_clamp(pCook->inventory[pActor->target - _ptT_nutrient_sources_first], get_from_tile(tileIdx, _Game.levelInfo.pGameplayMap[tileIdx].tileType, AddedResourceAmount));
+// Border tiles of the cluster in clockwise order, starting at the top left corner. Returns the number of tiles.
+size_t hierarchy_clusterPerimeter(const cluster_bounds &bounds, uint32_t *pTiles)
+{
+  const size_t width = _Game.levelInfo.map_size.x;
+  const size_t x1 = bounds.x0 + bounds.width - 1;
+  const size_t y1 = bounds.y0 + bounds.height - 1;
+  size_t count = 0;
 
-            if (_Game.levelInfo.pGameplayMap[tileIdx].resourceCount == 0)
-              _Game.levelInfo.pGameplayMap[tileIdx] = gameplay_element(tT_soil, 1); // no usage of `change_tile_to` due to earlier check of `resource_type`
+  for (size_t x = bounds.x0; x <= x1; x++)
+    pTiles[count++] = (uint32_t)(bounds.y0 * width + x);
 
-            pCook->state = caS_check_inventory;
-          }
-        }
+  for (size_t y = bounds.y0 + 1; y <= y1; y++)
+    pTiles[count++] = (uint32_t)(y * width + x1);
 
-        pActor->atDestination = false;
+  if (y1 > bounds.y0)
+    for (size_t x = x1; x-- > bounds.x0;)
+      pTiles[count++] = (uint32_t)(y1 * width + x);
 
-        break;
-      }
+  if (x1 > bounds.x0)
+    for (size_t y = y1; y-- > bounds.y0 + 1;)
+      pTiles[count++] = (uint32_t)(y * width + bounds.x0);
 
-      case caS_cook:
-      {
-        constexpr uint8_t AddedCookedItemAmount = 24;
-        pActor->atDestination = false;
+  return count;
+}
 
-        if (_Game.levelInfo.pGameplayMap[tileIdx].tileType != pCook->currentCookingItem || _Game.levelInfo.pGameplayMap[tileIdx].resourceCount == _Game.levelInfo.pGameplayMap[tileIdx].maxResourceCount)
-          break;
+// The first neighbour of `tileIndex` inside of `to` that can be walked to, `(size_t)-1` if there is none.
+size_t hierarchy_crossingNeighbor(const size_t tileIndex, const cluster_bounds &to)
+{
+  if (!hierarchy_walkable(tileIndex))
+    return (size_t)-1;
 
-        modify_with_clamp(_Game.levelInfo.pGameplayMap[tileIdx].resourceCount, AddedCookedItemAmount, uint8_t(0), _Game.levelInfo.pGameplayMap[tileIdx].maxResourceCount);
+  for (uint8_t d = d_topRight; d <= d_topLeft; d++)
+  {
+    const size_t neighbor = tileNeighbor(tileIndex, (direction)d);
 
-        for (size_t i = 0; i < LS_ARRAYSIZE(pCook->inventory); i++)
-        {
-          lsAssert(pCook->inventory[i] >= IngridientAmountPerFood[pCook->currentCookingItem - _tile_type_food_first][i]);
-          pCook->inventory[i] -= IngridientAmountPerFood[pCook->currentCookingItem - _tile_type_food_first][i];
-        }
+    if (hierarchy_localIndex(to, neighbor) != ClusterTileCount && hierarchy_walkable(neighbor) && tile_passableTowards(tileIndex, (direction)d))
+      return neighbor;
+  }
 
-        // change to next food item
-        pCook->currentCookingItem = getNextCookItem(pCook->currentCookingItem, tileIdx);
-        pCook->state = caS_check_inventory;
+  return (size_t)-1;
+}
 
-        break;
-      }
+uint32_t hierarchy_findNode(const list<pathfinding_cluster_node> &nodes, const list<uint32_t> &clusterFirstNode, const size_t tileIndex)
+{
+  const size_t cluster = hierarchy_tileCluster(tileIndex);
 
-      default:
-      {
-        lsFail(); // not implemented.
-      }
-      }
-    }
-    else
-    { // (Maybe remove in the future, if we *want* actors to be stuck, when the right tiles weren't provided)
-      const level_info::resource_info &info = _Game.levelInfo.resources[(resource_type)((pCook->currentCookingItem - _tile_type_food_first) + _ptT_drop_off_first)];
-      const direction d = info.pDirectionLookup[1 - info.write_direction_idx][tileIdx].dir;
+  for (uint32_t i = clusterFirstNode.pValues[cluster]; i < clusterFirstNode.pValues[cluster + 1]; i++)
+    if (nodes.pValues[i].tileIndex == tileIndex)
+      return i;
 
-      if (d == d_unreachable || d == d_unfillable)
-      {
-        pCook->currentCookingItem = getNextCookItem(pCook->currentCookingItem, tileIdx);
-        pCook->state = caS_check_inventory;
-      }
-    }
-  }
+  lsFail(); // not an entrance.
+  return 0;
 }
 
-//////////////////////////////////////////////////////////////////////////
+// Marks `cluster` and all clusters around it in `pBitset`.
+void hierarchy_addClusterNeighborhood(uint64_t *pBitset, const size_t cluster)
+{
+  const size_t clusterCountX = hierarchy_clusterCountX();
+  const size_t clusterCountY = hierarchy_clusterCount() / clusterCountX;
+  const size_t cx = cluster % clusterCountX;
+  const size_t cy = cluster / clusterCountX;
+
+  for (size_t y = (cy > 0 ? cy - 1 : 0); y <= lsMin(cy + 1, clusterCountY - 1); y++)
+    for (size_t x = (cx > 0 ? cx - 1 : 0); x <= lsMin(cx + 1, clusterCountX - 1); x++)
+      hierarchy_bitsetAdd(pBitset, y * clusterCountX + x);
+}
 
-void update_fireActor() // seems kinda sus - as if he's not always targeting all the fires but only starting some...
+// Rebuilds the entrance graph. With `graphDirty` everything is rebuilt, otherwise only the entrances of the clusters in `pDirtyClusters` and the walking distances inside of them and their neighbours,
+// everything else is taken over from the current graph. The current graph stays untouched if this fails.
+lsResult hierarchy_rebuild()
 {
-  constexpr pathfinding_target_type target_from_state[faS_count] = { ptT_wood, ptT_fire_pit, ptT_water, ptT_fire };
+  lsResult result = lsR_Success;
 
-  for (const auto _actor : _FireActors)
+  pathfinding_hierarchy &h = _Game.levelInfo.pathfindingHierarchy;
+  const size_t tileCount = _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y;
+  const bool full = h.graphDirty;
+
+  list<uint32_t> entrances; // Pairs of tiles in neighbouring clusters.
+  list<uint32_t> nodeTiles;
+  list<uint32_t> edgeSources; // Node of every edge in `unsortedEdges`.
+  list<pathfinding_cluster_edge> unsortedEdges;
+  list<pathfinding_cluster_node> nodes;
+  list<uint32_t> clusterFirstNode;
+  list<pathfinding_cluster_edge> edges;
+  list<uint32_t> rebuiltClusters;
+  uint64_t *pRebuilt = nullptr; // The dirty clusters and their neighbours, which need new walking distances.
+
+  const size_t clusterCount = hierarchy_clusterCount();
+  const size_t clusterCountX = hierarchy_clusterCountX();
+  const size_t bitsetWords = hierarchy_clusterBitsetWords();
+
+  if (full)
   {
-    fire_actor *pFireActor = _actor.pItem;
-    movement_actor *pActor = pool_get(_Game.movementActors, pFireActor->index);
+    LS_ERROR_CHECK(lsRealloc(&h.pTileTargets, tileCount));
+    LS_ERROR_CHECK(lsRealloc(&h.pClusterTargets, clusterCount));
+    LS_ERROR_CHECK(lsRealloc(&h.pClusterChangedTargets, clusterCount));
+    LS_ERROR_CHECK(lsRealloc(&h.pDirtyClusters, bitsetWords));
 
-    if (pActor->isWaiting)
-      continue;
+    lsZeroMemory(h.pClusterTargets, clusterCount);
+    lsZeroMemory(h.pClusterChangedTargets, clusterCount);
+    list_clear(&h.changedClusters);
 
-    // Handle Survival
-    if (pActor->survivalActorActive)
+    for (size_t i = 0; i < tileCount; i++)
     {
-      if (!pActor->isWaiting && (pActor->atDestination || _Game.levelInfo.isNight))
-      {
-        pActor->survivalActorActive = false;
-        pActor->target = target_from_state[pFireActor->state];
-        pActor->atDestination = false;
-
-        continue;
-      }
+      h.pTileTargets[i] = tile_target_mask(_Game.levelInfo.pGameplayMap[i]);
+      h.pClusterTargets[hierarchy_tileCluster(i)] |= h.pTileTargets[i];
     }
 
-    if (_Game.levelInfo.isNight)
+    for (size_t c = 0; c < clusterCount; c++)
+      hierarchy_bitsetAdd(h.pDirtyClusters, c);
+  }
+
+  LS_ERROR_CHECK(lsAllocZero(&pRebuilt, bitsetWords));
+
+  for (size_t w = 0; w < bitsetWords; w++)
+    for (uint64_t bits = h.pDirtyClusters[w]; bits; bits &= bits - 1)
+      hierarchy_addClusterNeighborhood(pRebuilt, w * 64 + lsLowestBit(bits));
+
+  // Entrances between two clusters that aren't dirty are taken over from the current graph.
+  if (!full)
+  {
+    for (size_t n = 0; n < h.nodes.count; n++)
     {
-      if (pFireActor->state == faS_extinguish_fire)
+      const pathfinding_cluster_node &node = h.nodes.pValues[n];
+      const size_t cluster = hierarchy_tileCluster(node.tileIndex);
+
+      if (hierarchy_bitsetContains(h.pDirtyClusters, cluster))
+        continue;
+
+      for (uint32_t i = node.firstEdge; i < node.firstEdge + node.edgeCount; i++)
       {
-        pFireActor->state = faS_start_fire;
+        const uint32_t otherTile = h.nodes.pValues[h.edges.pValues[i].node].tileIndex;
+        const size_t otherCluster = hierarchy_tileCluster(otherTile);
 
-        if (!pActor->survivalActorActive)
-        {
-          pActor->target = target_from_state[faS_start_fire];
-          pActor->atDestination = false;
-        }
+        if (otherCluster <= cluster || hierarchy_bitsetContains(h.pDirtyClusters, otherCluster)) // Edges inside of the cluster aren't entrances, the others are stored on both of their nodes.
+          continue;
+
+        LS_ERROR_CHECK(list_add(&entrances, node.tileIndex));
+        LS_ERROR_CHECK(list_add(&entrances, otherTile));
       }
     }
-    else
+  }
+
+  // Every run of border tiles that can be walked into the same neighbouring cluster becomes one entrance, placed in the middle of the run.
+  for (size_t a = 0; a < clusterCount; a++)
+  {
+    if (!hierarchy_bitsetContains(pRebuilt, a)) // Neither this cluster nor any of its neighbours is dirty.
+      continue;
+
+    uint32_t perimeter[4 * PathfindingClusterSize];
+    const size_t perimeterCount = hierarchy_clusterPerimeter(hierarchy_clusterBounds(a), perimeter);
+    const int64_t ax = (int64_t)(a % clusterCountX);
+    const int64_t ay = (int64_t)(a / clusterCountX);
+
+    // Only the neighbours with a higher index, the others have already been connected to this cluster.
+    constexpr int64_t NeighborOffsets[][2] = { { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 } };
+
+    for (const auto &offset : NeighborOffsets)
     {
-      if (pFireActor->state == faS_start_fire)
+      const int64_t bx = ax + offset[0];
+      const int64_t by = ay + offset[1];
+
+      if (bx < 0 || bx >= (int64_t)clusterCountX || by >= (int64_t)(clusterCount / clusterCountX))
+        continue;
+
+      const size_t b = (size_t)(by * (int64_t)clusterCountX + bx);
+
+      if (!hierarchy_bitsetContains(h.pDirtyClusters, a) && !hierarchy_bitsetContains(h.pDirtyClusters, b)) // Taken over above.
+        continue;
+
+      const cluster_bounds to = hierarchy_clusterBounds(b);
+      size_t runStart = 0;
+      size_t runLength = 0;
+
+      for (size_t i = 0; i <= perimeterCount; i++)
       {
-        pFireActor->state = faS_extinguish_fire;
+        if (i < perimeterCount && hierarchy_crossingNeighbor(perimeter[i], to) != (size_t)-1)
+        {
+          if (!runLength)
+            runStart = i;
 
-        if (!pActor->survivalActorActive)
+          runLength++;
+        }
+        else if (runLength)
         {
-          pActor->target = target_from_state[faS_extinguish_fire]; // TODO: do we want the actor to be able to extinguish the fire if he is stuck searching for food/wood if a new fire emerged?
-          pActor->atDestination = false;
+          const uint32_t tile = perimeter[runStart + runLength / 2];
+
+          LS_ERROR_CHECK(list_add(&entrances, tile));
+          LS_ERROR_CHECK(list_add(&entrances, (uint32_t)hierarchy_crossingNeighbor(tile, to)));
+          runLength = 0;
         }
       }
     }
+  }
+
+  // Sort the entrance tiles by cluster and drop duplicates.
+  {
+    LS_ERROR_CHECK(list_resize(&clusterFirstNode, clusterCount + 1, (uint32_t)0));
+    LS_ERROR_CHECK(list_resize(&nodeTiles, entrances.count, (uint32_t)0));
+
+    for (size_t i = 0; i < entrances.count; i++)
+      clusterFirstNode.pValues[hierarchy_tileCluster(entrances.pValues[i]) + 1]++;
+
+    for (size_t c = 1; c <= clusterCount; c++)
+      clusterFirstNode.pValues[c] += clusterFirstNode.pValues[c - 1];
+
+    for (size_t i = 0; i < entrances.count; i++)
+      nodeTiles.pValues[clusterFirstNode.pValues[hierarchy_tileCluster(entrances.pValues[i])]++] = entrances.pValues[i];
 
-    if (pActor->atDestination)
+    // Every cluster now starts where the previous one did.
+    for (size_t c = clusterCount; c > 0; c--)
+      clusterFirstNode.pValues[c] = clusterFirstNode.pValues[c - 1];
+
+    clusterFirstNode.pValues[0] = 0;
+
+    for (size_t c = 0; c < clusterCount; c++)
     {
-      const size_t tileIdx = worldPosToTileIndex(pActor->pos);
-      switch (pFireActor->state)
-      {
-      case faS_get_wood:
+      const uint32_t begin = clusterFirstNode.pValues[c];
+      const uint32_t end = clusterFirstNode.pValues[c + 1];
+      clusterFirstNode.pValues[c] = (uint32_t)nodes.count;
+
+      for (uint32_t i = begin; i < end; i++)
       {
-        constexpr int16_t AddedWood = 6;
-        const resource_type currentTileType = _Game.levelInfo.pGameplayMap[tileIdx].tileType;
+        bool duplicate = false;
 
-        if (currentTileType == tT_market || currentTileType == tT_wood)
-        {
-          //if (_Game.levelInfo.pGameplayMap[tileIdx].resourceCount > 0)
-          {
-            modify_with_clamp(pFireActor->wood_inventory, get_from_tile(tileIdx, tT_wood, AddedWood));
+        for (size_t j = clusterFirstNode.pValues[c]; j < nodes.count && !duplicate; j++)
+          duplicate = nodes.pValues[j].tileIndex == nodeTiles.pValues[i];
+
+        if (!duplicate)
+          LS_ERROR_CHECK(list_add(&nodes, pathfinding_cluster_node{ nodeTiles.pValues[i], 0, 0 }));
+      }
+    }
 
-            //if (_Game.levelInfo.pGameplayMap[tileIdx].resourceCount == 0)
-            //  _Game.levelInfo.pGameplayMap[tileIdx] = gameplay_element(tT_soil, 1); // No usage of `change_tile_to` because of check above.
+    clusterFirstNode.pValues[clusterCount] = (uint32_t)nodes.count;
+  }
 
-            pFireActor->state = faS_start_fire;
-            pActor->target = target_from_state[faS_start_fire];
-          }
-        }
+  for (size_t i = 0; i < entrances.count; i += 2)
+  {
+    const uint32_t a = hierarchy_findNode(nodes, clusterFirstNode, entrances.pValues[i]);
+    const uint32_t b = hierarchy_findNode(nodes, clusterFirstNode, entrances.pValues[i + 1]);
 
-        pActor->atDestination = false;
+    LS_ERROR_CHECK(list_add(&edgeSources, a));
+    LS_ERROR_CHECK(list_add(&unsortedEdges, pathfinding_cluster_edge{ b, 1 }));
+    LS_ERROR_CHECK(list_add(&edgeSources, b));
+    LS_ERROR_CHECK(list_add(&unsortedEdges, pathfinding_cluster_edge{ a, 1 }));
+  }
 
-        break;
-      }
-      case faS_start_fire:
+  // Walking distances between the entrances of the same cluster.
+  for (size_t c = 0; c < clusterCount; c++)
+  {
+    const uint32_t firstNode = clusterFirstNode.pValues[c];
+    const uint32_t lastNode = clusterFirstNode.pValues[c + 1];
+
+    if (!hierarchy_bitsetContains(pRebuilt, c)) // Neither its tiles nor its entrances changed.
+    {
+      for (uint32_t n = h.clusterFirstNode.pValues[c]; n < h.clusterFirstNode.pValues[c + 1]; n++)
       {
-        constexpr int16_t WoodPerFire = 3;
+        const pathfinding_cluster_node &node = h.nodes.pValues[n];
+        const uint32_t newNode = hierarchy_findNode(nodes, clusterFirstNode, node.tileIndex);
 
-        if (_Game.levelInfo.isNight)
-        {
-          if (_Game.levelInfo.pGameplayMap[tileIdx].tileType == tT_fire_pit)
-          {
-            if (_Game.levelInfo.pGameplayMap[tileIdx].resourceCount > WoodPerFire) // TODO: A fire should propably not only loose wood, when someone was there, but just slowly over time or when extinguished.
-            {
-              _Game.levelInfo.pGameplayMap[tileIdx].tileType = tT_fire; // No usage of `change_tile_to` because of check above. Actually okay to just change the tileType as we want to keep `count` and `maxResourceCount` between `tT_fire` and `tT_fire_pit` are the same.
-            }
-            else
-            {
-              // if has wood: add wood to fire
-              if (pFireActor->wood_inventory >= WoodPerFire)
-              {
-                pFireActor->wood_inventory -= WoodPerFire;
-                _Game.levelInfo.pGameplayMap[tileIdx].tileType = tT_fire; // No usage of `change_tile_to` because of check above. Actually okay to just change the tileType as we want to keep `count` and `maxResourceCount` between `tT_fire` and `tT_fire_pit` are the same.
-                modify_with_clamp(_Game.levelInfo.pGameplayMap[tileIdx].resourceCount, WoodPerFire, (uint8_t)(0), _Game.levelInfo.pGameplayMap[tileIdx].maxResourceCount);
-              }
-              else
-              {
-                pFireActor->state = faS_get_wood;
-                pActor->target = target_from_state[faS_get_wood];
-              }
-            }
-          }
-        }
-        else
+        for (uint32_t i = node.firstEdge; i < node.firstEdge + node.edgeCount; i++)
         {
-          pFireActor->state = faS_extinguish_fire;
-          pActor->target = target_from_state[faS_extinguish_fire];
-        }
+          const pathfinding_cluster_edge &edge = h.edges.pValues[i];
+          const uint32_t otherTile = h.nodes.pValues[edge.node].tileIndex;
 
-        pActor->atDestination = false;
+          if (hierarchy_tileCluster(otherTile) != c)
+            continue;
 
-        break;
+          LS_ERROR_CHECK(list_add(&edgeSources, newNode));
+          LS_ERROR_CHECK(list_add(&unsortedEdges, pathfinding_cluster_edge{ hierarchy_findNode(nodes, clusterFirstNode, otherTile), edge.cost }));
+        }
       }
-      case faS_get_water:
-      {
-        constexpr int16_t AddedWater = 4;
 
-        if (_Game.levelInfo.pGameplayMap[tileIdx].tileType == tT_water)
-        {
-          if (_Game.levelInfo.pGameplayMap[tileIdx].resourceCount > 0)
-          {
-            //modify_with_clamp(pFireActor->water_inventory, lsMin(AddedWater, (int16_t)_Game.levelInfo.pGameplayMap[tileIdx].resourceCount));
-            lsAssert(pFireActor->water_inventory < 255);
-            pFireActor->water_inventory += AddedWater;
+      continue;
+    }
 
-            pFireActor->state = faS_extinguish_fire;
-            pActor->target = target_from_state[faS_extinguish_fire];
-          }
-        }
+    LS_ERROR_CHECK(list_add(&rebuiltClusters, (uint32_t)c));
 
-        pActor->atDestination = false;
+    const cluster_bounds bounds = hierarchy_clusterBounds(c);
 
-        break;
-      }
-      case faS_extinguish_fire:
-      {
-        constexpr int16_t WaterPerFire = 1;
+    for (uint32_t n = firstNode; n < lastNode; n++)
+    {
+      uint16_t dist[ClusterTileCount];
 
-        if (_Game.levelInfo.isNight)
-        {
-          pFireActor->state = faS_start_fire;
-          pActor->target = target_from_state[faS_extinguish_fire];
-        }
-        else
-        {
-          if (pFireActor->water_inventory >= WaterPerFire)
-          {
-            if (change_tile_to(tT_fire_pit, tT_fire, tileIdx, _Game.levelInfo.pGameplayMap[tileIdx].resourceCount))
-              pFireActor->water_inventory -= WaterPerFire;
-          }
-          else
-          {
-            pFireActor->state = faS_get_water;
-            pActor->target = target_from_state[faS_get_water];
-          }
-        }
+      for (size_t i = 0; i < ClusterTileCount; i++)
+        dist[i] = UnreachedClusterDistance;
 
-        pActor->atDestination = false;
+      dist[hierarchy_localIndex(bounds, nodes.pValues[n].tileIndex)] = 0;
+      hierarchy_clusterFill(bounds, dist);
 
-        break;
-      }
-      default:
+      for (uint32_t m = firstNode; m < lastNode; m++)
       {
-        lsFail(); // not implemented.
-      }
+        const uint16_t d = dist[hierarchy_localIndex(bounds, nodes.pValues[m].tileIndex)];
+
+        if (m == n || d == UnreachedClusterDistance)
+          continue;
+
+        LS_ERROR_CHECK(list_add(&edgeSources, n));
+        LS_ERROR_CHECK(list_add(&unsortedEdges, pathfinding_cluster_edge{ m, d }));
       }
     }
   }
-}
 
-//////////////////////////////////////////////////////////////////////////
+  // Group the edges by node.
+  {
+    for (size_t i = 0; i < edgeSources.count; i++)
+      nodes.pValues[edgeSources.pValues[i]].edgeCount++;
 
-// TODO: handle nutrition loss? maybe ok in survival actor, but maybe some more thoughtthrough way
+    uint32_t offset = 0;
 
-static size_t ticksSincelastDayNightSwitch = 0;
+    for (size_t i = 0; i < nodes.count; i++)
+    {
+      nodes.pValues[i].firstEdge = offset;
+      offset += nodes.pValues[i].edgeCount;
+      nodes.pValues[i].edgeCount = 0;
+    }
 
-void handle_dayNightCycle()
-{
-  constexpr size_t DayLength = 500;
-  constexpr size_t NightLength = 300;
+    LS_ERROR_CHECK(list_resize(&edges, unsortedEdges.count, pathfinding_cluster_edge{ 0, 0 }));
 
-  if (ticksSincelastDayNightSwitch == DayLength && !_Game.levelInfo.isNight)
-  {
-    _Game.levelInfo.isNight = true;
-    ticksSincelastDayNightSwitch = 0;
-  }
-  else if (ticksSincelastDayNightSwitch == NightLength && _Game.levelInfo.isNight)
-  {
-    _Game.levelInfo.isNight = false;
-    ticksSincelastDayNightSwitch = 0;
+    for (size_t i = 0; i < edgeSources.count; i++)
+    {
+      pathfinding_cluster_node &node = nodes.pValues[edgeSources.pValues[i]];
+      edges.pValues[node.firstEdge + node.edgeCount++] = unsortedEdges.pValues[i];
+    }
   }
 
-  ticksSincelastDayNightSwitch++;
-}
+  std::swap(h.nodes, nodes);
+  std::swap(h.clusterFirstNode, clusterFirstNode);
+  std::swap(h.edges, edges);
+  std::swap(h.rebuiltClusters, rebuiltClusters);
 
-//////////////////////////////////////////////////////////////////////////
+  lsZeroMemory(h.pDirtyClusters, bitsetWords);
+  h.processedChangeCount = _Game.levelInfo.tileChanges.count;
+  h.graphVersion++;
+  h.graphDirty = false;
+  h.clustersDirty = false;
 
-void game_update()
-{
-  handle_dayNightCycle();
-  updateFloodfill();
-  movementActor_move();
-  update_lifesupportActors();
-  update_lumberjack();
-  update_farmer();
-  update_cook();
-  update_fireActor();
+epilogue:
+  lsFreePtr(&pRebuilt);
+  return result;
 }
 
-//////////////////////////////////////////////////////////////////////////
-
-void print_resouceType(const resource_type type)
+// Keeps the entrance graph and the tile classification up to date with `tileChanges`. Runs on the game thread before the targets are updated.
+void hierarchy_update()
 {
-  const char *types[] = { "tT_grass", "tT_soil", "tT_water", "tT_sand", "tT_sapling", "tT_tree", "tT_trunk", "tT_wood", "tT_fire", "tT_fire_pit", "tT_market",
-  "tT_tomato_plant", "tT_bean_plant", "tT_wheat_plant", "tT_sunflower_plant", "tT_tomato", "tT_bean", "tT_wheat", "tT_sunflower", "tT_meal", "tT_mountain" };
+  constexpr uint32_t MaxRebuildBackoffTicks = 64;
 
-  lsAssert(LS_ARRAYSIZE(types) == tT_count);
-  print(types[type], '\n');
-}
+  pathfinding_hierarchy &h = _Game.levelInfo.pathfindingHierarchy;
 
-void game_playerSwitchTiles(const resource_type terrainType)
-{
-  lsAssert(_Game.levelInfo.playerPos.x >= 1 && _Game.levelInfo.playerPos.x <= _Game.levelInfo.map_size.x - 2 && _Game.levelInfo.playerPos.y >= 0 && _Game.levelInfo.playerPos.y <= _Game.levelInfo.map_size.y - 2);
+  for (const uint32_t cluster : h.changedClusters)
+    h.pClusterChangedTargets[cluster] = 0;
 
-  const size_t idx = worldPosToTileIndex((vec2f)(_Game.levelInfo.playerPos));
+  list_clear(&h.changedClusters);
 
-  lsAssert(idx < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
-  lsAssert(terrainType < tT_count);
+  for (size_t i = h.processedChangeCount; i < _Game.levelInfo.tileChanges.count && !h.graphDirty; i++)
+  {
+    const tile_change change = _Game.levelInfo.tileChanges.pValues[i];
+    const target_mask mask = tile_target_mask(_Game.levelInfo.pGameplayMap[change.tileIndex]);
+    const target_mask changed = mask ^ h.pTileTargets[change.tileIndex];
 
-  lsAssert(setGameplayTile(idx, terrainType, MaxResourceCounts[terrainType]) == lsR_Success);
+    // The passable neighbours of the tiles around it changed as well, these may belong to other clusters.
+    if (change.passabilityChanged || (changed & CollidableTargetBit))
+    {
+      const size_t x = change.tileIndex % _Game.levelInfo.map_size.x;
+      const size_t y = change.tileIndex / _Game.levelInfo.map_size.x;
 
-#ifdef _DEBUG
-  print("Changed tile (", _Game.levelInfo.playerPos.x, ", ", _Game.levelInfo.playerPos.y, ") to: ");
-  print_resouceType(terrainType);
-#endif
+      for (size_t ny = (y > 0 ? y - 1 : 0); ny <= lsMin(y + 1, _Game.levelInfo.map_size.y - 1); ny++)
+        for (size_t nx = (x > 0 ? x - 1 : 0); nx <= lsMin(x + 1, _Game.levelInfo.map_size.x - 1); nx++)
+          hierarchy_bitsetAdd(h.pDirtyClusters, hierarchy_tileCluster(ny * _Game.levelInfo.map_size.x + nx));
 
-}
+      h.clustersDirty = true;
+    }
 
-void game_setPlayerMapIndex(const direction dir)
-{
-  lsAssert(dir > d_unreachable && dir < d_atDestination);
-  lsAssert(_Game.levelInfo.playerPos.x >= 1 && _Game.levelInfo.playerPos.x <= _Game.levelInfo.map_size.x - 2 && _Game.levelInfo.playerPos.y >= 0 && _Game.levelInfo.playerPos.y <= _Game.levelInfo.map_size.y - 2);
+    if (!changed)
+      continue;
 
-  static const vec2i16 EvenDir[] = { vec2i16(0, -1), vec2i16(1, 0), vec2i16(0, 1), vec2i16(-1, 1), vec2i16(-1, 0), vec2i16(-1, -1) };
-  static const vec2i16 OddDir[] = { vec2i16(1, -1), vec2i16(1, 0), vec2i16(1, 1), vec2i16(0, 1), vec2i16(-1, 0), vec2i16(0, -1) };
+    const size_t cluster = hierarchy_tileCluster(change.tileIndex);
 
-  const vec2i16 newPos = _Game.levelInfo.playerPos.y % 2 ? _Game.levelInfo.playerPos + OddDir[dir - 1] : _Game.levelInfo.playerPos + EvenDir[dir - 1];
+    if (!h.pClusterChangedTargets[cluster] && LS_FAILED(list_add(&h.changedClusters, (uint32_t)cluster)))
+    {
+      h.graphDirty = true; // Can't keep track of the change, start over.
+      break;
+    }
 
-  if (newPos.x >= 1 && newPos.x <= _Game.levelInfo.map_size.x - 2 && newPos.y >= 1 && newPos.y <= _Game.levelInfo.map_size.y - 2)
-    _Game.levelInfo.playerPos = newPos;
-}
+    h.pTileTargets[change.tileIndex] = mask;
+    h.pClusterChangedTargets[cluster] |= changed;
+  }
 
-//////////////////////////////////////////////////////////////////////////
+  if (!h.graphDirty)
+  {
+    for (const uint32_t cluster : h.changedClusters)
+    {
+      const cluster_bounds bounds = hierarchy_clusterBounds(cluster);
+      h.pClusterTargets[cluster] = 0;
 
-lsResult game_init()
-{
-  return game_init_local();
-}
+      for (size_t y = 0; y < bounds.height; y++)
+        for (size_t x = 0; x < bounds.width; x++)
+          h.pClusterTargets[cluster] |= h.pTileTargets[(bounds.y0 + y) * _Game.levelInfo.map_size.x + bounds.x0 + x];
+    }
 
-lsResult game_tick()
-{
-  return game_tick_local();
-}
+    h.processedChangeCount = _Game.levelInfo.tileChanges.count; // Otherwise the full rebuild classifies every tile again.
+  }
 
-//////////////////////////////////////////////////////////////////////////
+  if (!h.graphDirty && !h.clustersDirty)
+    return;
 
-game *game_getGame()
-{
-  return &_Game;
+  // Targets wait until this succeeds. Failures are retried after a growing number of ticks, instead of rebuilding every tick while memory is short.
+  if (h.ticksUntilRebuild)
+  {
+    h.ticksUntilRebuild--;
+  }
+  else if (LS_FAILED(hierarchy_rebuild()))
+  {
+    h.rebuildBackoffTicks = lsClamp(h.rebuildBackoffTicks * 2, (uint32_t)1, MaxRebuildBackoffTicks);
+    h.ticksUntilRebuild = h.rebuildBackoffTicks;
+  }
+  else
+  {
+    h.rebuildBackoffTicks = 0;
+  }
 }
 
-size_t game_getTickRate()
+void hierarchy_destroy()
 {
-  return _Game.tickRate;
+  pathfinding_hierarchy &h = _Game.levelInfo.pathfindingHierarchy;
+
+  list_destroy(&h.nodes);
+  list_destroy(&h.clusterFirstNode);
+  list_destroy(&h.edges);
+  list_destroy(&h.changedClusters);
+  lsFreePtr(&h.pTileTargets);
+  lsFreePtr(&h.pClusterTargets);
+  lsFreePtr(&h.pClusterChangedTargets);
+  lsFreePtr(&h.pDirtyClusters);
+  list_destroy(&h.rebuiltClusters);
+
+  h.graphDirty = true;
+  h.clustersDirty = false;
+  h.rebuildBackoffTicks = 0;
+  h.ticksUntilRebuild = 0;
 }
 
-//////////////////////////////////////////////////////////////////////////
-
-lsResult game_init_local()
+// Distance from the entrances of `cluster` to the closest tile of the target without leaving the cluster.
+void hierarchy_seedCluster(level_info::resource_info &info, const size_t cluster, const target_mask targetBit)
 {
-  lsResult result = lsR_Success;
+  const pathfinding_hierarchy &h = _Game.levelInfo.pathfindingHierarchy;
+  const uint32_t firstNode = h.clusterFirstNode.pValues[cluster];
+  const uint32_t lastNode = h.clusterFirstNode.pValues[cluster + 1];
 
-  initializeLevel();
-  _Game.gameStartTimeNs = _Game.lastUpdateTimeNs = lsGetCurrentTimeNs();
+  if (firstNode == lastNode)
+    return;
 
-  goto epilogue;
-epilogue:
-  return result;
+  if (!(h.pClusterTargets[cluster] & targetBit))
+  {
+    for (uint32_t n = firstNode; n < lastNode; n++)
+      info.pNodeSeedDistances[n] = UnreachableNodeDistance;
+
+    return;
+  }
+
+  const cluster_bounds bounds = hierarchy_clusterBounds(cluster);
+  uint16_t dist[ClusterTileCount];
+
+  for (size_t i = 0; i < ClusterTileCount; i++)
+    dist[i] = UnreachedClusterDistance;
+
+  for (size_t y = 0; y < bounds.height; y++)
+    for (size_t x = 0; x < bounds.width; x++)
+      if (h.pTileTargets[(bounds.y0 + y) * _Game.levelInfo.map_size.x + bounds.x0 + x] & targetBit)
+        dist[y * PathfindingClusterSize + x] = 0;
+
+  hierarchy_clusterFill(bounds, dist);
+
+  for (uint32_t n = firstNode; n < lastNode; n++)
+  {
+    const uint16_t d = dist[hierarchy_localIndex(bounds, h.nodes.pValues[n].tileIndex)];
+    info.pNodeSeedDistances[n] = d == UnreachedClusterDistance ? UnreachableNodeDistance : d;
+  }
+}
+
+// Fills the entrance graph from the seeded nodes. Seeds don't share a distance, so nodes may be reached more than once until they settle on their shortest path.
+lsResult hierarchy_fillNodes(level_info::resource_info &info)
+{
+  lsResult result = lsR_Success;
+
+  const pathfinding_hierarchy &h = _Game.levelInfo.pathfindingHierarchy;
+  queue<fill_step> &nodeQueue = info.pathfinding_queue;
+
+  queue_clear(&nodeQueue);
+
+  for (size_t n = 0; n < h.nodes.count; n++)
+  {
+    info.pNodeDistances[n] = info.pNodeSeedDistances[n];
+
+    if (info.pNodeSeedDistances[n] != UnreachableNodeDistance)
+      LS_ERROR_CHECK(queue_pushBack(&nodeQueue, fill_step(n, info.pNodeSeedDistances[n])));
+  }
+
+  {
+    fill_step current;
+
+    while (nodeQueue.count)
+    {
+      queue_popFront(&nodeQueue, &current);
+
+      if (info.pNodeDistances[current.index] < current.dist) // Outdated step.
+        continue;
+
+      const pathfinding_cluster_node &node = h.nodes.pValues[current.index];
+
+      for (uint32_t i = node.firstEdge; i < node.firstEdge + node.edgeCount; i++)
+      {
+        const pathfinding_cluster_edge &edge = h.edges.pValues[i];
+        const uint32_t nextDist = current.dist + edge.cost;
+
+        if (nextDist >= info.pNodeDistances[edge.node])
+          continue;
+
+        info.pNodeDistances[edge.node] = nextDist;
+        LS_ERROR_CHECK(queue_pushBack(&nodeQueue, fill_step(edge.node, nextDist)));
+      }
+    }
+  }
+
+epilogue:
+  return result;
+}
+
+// Writes the directions of all tiles in `cluster` to the read direction map. Paths that don't end inside of the cluster leave it through the entrance closest to the target.
+lsResult hierarchy_detailCluster(level_info::resource_info &info, const target_mask targetBit, const size_t cluster)
+{
+  lsResult result = lsR_Success;
+
+  const pathfinding_hierarchy &h = _Game.levelInfo.pathfindingHierarchy;
+  direction_map &readMap = info.directionMaps[1 - info.write_direction_idx];
+  queue<fill_step> &detailQueue = info.pathfinding_queue;
+  const cluster_bounds bounds = hierarchy_clusterBounds(cluster);
+
+  uint32_t dist[ClusterTileCount];
+  direction dirs[ClusterTileCount];
+
+  queue_clear(&detailQueue);
+
+  for (size_t y = 0; y < bounds.height; y++)
+  {
+    for (size_t x = 0; x < bounds.width; x++)
+    {
+      const size_t index = (bounds.y0 + y) * _Game.levelInfo.map_size.x + bounds.x0 + x;
+      const size_t local = y * PathfindingClusterSize + x;
+
+      dist[local] = UnreachableNodeDistance;
+      dirs[local] = d_unreachable;
+
+      if (h.pTileTargets[index] & targetBit)
+      {
+        dist[local] = 0;
+        dirs[local] = d_atDestination;
+        LS_ERROR_CHECK(queue_pushBack(&detailQueue, fill_step(index, 0)));
+      }
+      else if (h.pTileTargets[index] & CollidableTargetBit)
+      {
+        dirs[local] = d_unfillable;
+      }
+    }
+  }
+
+  // Entrances continue the paths of the neighbouring clusters.
+  for (uint32_t n = h.clusterFirstNode.pValues[cluster]; n < h.clusterFirstNode.pValues[cluster + 1]; n++)
+  {
+    const pathfinding_cluster_node &node = h.nodes.pValues[n];
+    const size_t local = hierarchy_localIndex(bounds, node.tileIndex);
+
+    if (dirs[local] == d_atDestination)
+      continue;
+
+    const uint32_t previousDist = dist[local];
+
+    for (uint32_t i = node.firstEdge; i < node.firstEdge + node.edgeCount; i++)
+    {
+      const pathfinding_cluster_edge &edge = h.edges.pValues[i];
+      const uint32_t entranceTile = h.nodes.pValues[edge.node].tileIndex;
+
+      if (hierarchy_localIndex(bounds, entranceTile) != ClusterTileCount || info.pNodeDistances[edge.node] == UnreachableNodeDistance) // Edges inside of the cluster are walked below.
+        continue;
+
+      if (info.pNodeDistances[edge.node] + edge.cost < dist[local])
+      {
+        dist[local] = info.pNodeDistances[edge.node] + edge.cost;
+        dirs[local] = tileDirection(entranceTile, node.tileIndex);
+      }
+    }
+
+    if (dist[local] != previousDist)
+      LS_ERROR_CHECK(queue_pushBack(&detailQueue, fill_step(node.tileIndex, dist[local])));
+  }
+
+  // Seeds don't share a distance, so tiles may be reached more than once until they settle on their shortest path.
+  {
+    fill_step current;
+
+    while (detailQueue.count)
+    {
+      queue_popFront(&detailQueue, &current);
+
+      if (dist[hierarchy_localIndex(bounds, current.index)] < current.dist) // Outdated step.
+        continue;
+
+      for (uint8_t d = d_topRight; d <= d_topLeft; d++)
+      {
+        const size_t neighbor = tileNeighbor(current.index, (direction)d);
+        const size_t neighborLocal = hierarchy_localIndex(bounds, neighbor);
+
+        if (neighborLocal == ClusterTileCount || dirs[neighborLocal] == d_unfillable || dirs[neighborLocal] == d_atDestination || current.dist + 1 >= dist[neighborLocal] || !tile_passableTowards(current.index, (direction)d))
+          continue;
+
+        dist[neighborLocal] = current.dist + 1;
+        dirs[neighborLocal] = (direction)d;
+        LS_ERROR_CHECK(queue_pushBack(&detailQueue, fill_step(neighbor, current.dist + 1)));
+      }
+    }
+  }
+
+  for (size_t y = 0; y < bounds.height; y++)
+    for (size_t x = 0; x < bounds.width; x++)
+      direction_map_set(readMap, (bounds.y0 + y) * _Game.levelInfo.map_size.x + bounds.x0 + x, dirs[y * PathfindingClusterSize + x], dist[y * PathfindingClusterSize + x]);
+
+epilogue:
+  return result;
+}
+
+// Brings the entrance distances of `target` up to date with the changes of this tick and details the clusters that were queried since the last update.
+// Only touches the state of `target`, just like the fills.
+lsResult hierarchy_update_target(level_info::resource_info &info, const size_t target, _Out_ bool *pDetailed)
+{
+  lsResult result = lsR_Success;
+
+  const pathfinding_hierarchy &h = _Game.levelInfo.pathfindingHierarchy;
+  const target_mask targetBit = (target_mask)1 << target;
+  const size_t nodeCount = h.nodes.count;
+  const size_t bitsetWords = hierarchy_clusterBitsetWords();
+  bool nodesChanged = false;
+
+  *pDetailed = false;
+
+  if (info.hierarchyGraphVersion != h.graphVersion)
+  {
+    LS_ERROR_CHECK(lsRealloc(&info.pNodeDistances, lsMax((size_t)1, nodeCount)));
+    LS_ERROR_CHECK(lsRealloc(&info.pPreviousNodeDistances, lsMax((size_t)1, nodeCount)));
+    LS_ERROR_CHECK(lsRealloc(&info.pNodeSeedDistances, lsMax((size_t)1, nodeCount)));
+
+    for (size_t n = 0; n < nodeCount; n++)
+      info.pNodeDistances[n] = UnreachableNodeDistance;
+
+    for (size_t c = 0; c < hierarchy_clusterCount(); c++)
+      hierarchy_seedCluster(info, c, targetBit);
+
+    lsZeroMemory(info.pClusterDetailed, bitsetWords);
+    nodesChanged = true;
+  }
+  else
+  {
+    for (const uint32_t cluster : h.changedClusters)
+    {
+      if (!(h.pClusterChangedTargets[cluster] & targetBit))
+        continue;
+
+      hierarchy_seedCluster(info, cluster, targetBit);
+      hierarchy_bitsetRemove(info.pClusterDetailed, cluster);
+      nodesChanged = true;
+    }
+  }
+
+  if (nodesChanged)
+  {
+    std::swap(info.pNodeDistances, info.pPreviousNodeDistances);
+    LS_ERROR_CHECK(hierarchy_fillNodes(info));
+
+    // Clusters on both sides of an entrance that got a different distance have to be detailed again.
+    for (size_t n = 0; n < nodeCount; n++)
+    {
+      if (info.pNodeDistances[n] == info.pPreviousNodeDistances[n])
+        continue;
+
+      const pathfinding_cluster_node &node = h.nodes.pValues[n];
+      hierarchy_bitsetRemove(info.pClusterDetailed, hierarchy_tileCluster(node.tileIndex));
+
+      for (uint32_t i = node.firstEdge; i < node.firstEdge + node.edgeCount; i++)
+        hierarchy_bitsetRemove(info.pClusterDetailed, hierarchy_tileCluster(h.nodes.pValues[h.edges.pValues[i].node].tileIndex));
+    }
+  }
+
+  for (size_t w = 0; w < bitsetWords; w++)
+  {
+    for (uint64_t bits = info.pClusterQueried[w] & ~info.pClusterDetailed[w]; bits; bits &= bits - 1)
+    {
+      LS_ERROR_CHECK(hierarchy_detailCluster(info, targetBit, w * 64 + lsLowestBit(bits)));
+      *pDetailed = true;
+    }
+
+    info.pClusterDetailed[w] |= info.pClusterQueried[w];
+    info.pClusterQueried[w] = 0;
+  }
+
+  info.hierarchyGraphVersion = h.graphVersion;
+
+epilogue:
+  return result;
+}
+
+enum pathfinding_step_result : uint8_t
+{
+  pSR_none,
+  pSR_fillCompleted,
+  pSR_repairFailed,
+  pSR_hierarchyUpdated,
+};
+
+static pathfinding_step_result _PathfindingStepResults[ptT_Count - 1];
+
+// Advances the fill or repair of one target. Only touches the state of that target, so targets can be updated in parallel.
+// Everything shared (buffer swaps, rebuilds, the change list) is handled by `updateFloodfill` once all targets are done.
+void update_resource_info(const size_t target)
+{
+  level_info::resource_info &info = _Game.levelInfo.resources[target];
+  _PathfindingStepResults[target] = pSR_none;
+
+  if (info.directionMaps[0].pDirections == nullptr) // Not resident.
+    return;
+
+  if (_Game.levelInfo.pathfindingLayout == pL_hierarchical)
+  {
+    if (_Game.levelInfo.pathfindingHierarchy.graphDirty || _Game.levelInfo.pathfindingHierarchy.clustersDirty) // Wait for the entrance graph.
+      return;
+
+    bool detailed = false;
+
+    if (LS_FAILED(hierarchy_update_target(info, target, &detailed)))
+    {
+      // Out of memory: start over next tick.
+      queue_clear(&info.pathfinding_queue);
+      info.hierarchyGraphVersion = 0;
+    }
+    else if (detailed || !info.hasReadMap)
+    {
+      _PathfindingStepResults[target] = pSR_hierarchyUpdated;
+    }
+
+    return;
+  }
+
+  if (info.fieldComplete)
+  {
+    if (info.readSeedChangeTotal == info.changeTotal) // None of the journaled changes affect this target.
+    {
+      info.processedChangeCount = _Game.levelInfo.tileChanges.count;
+      return;
+    }
+
+    if (repair_resource_info(info, (pathfinding_target_type)target) != lsR_Success)
+    {
+      // Out of memory: fall back to refilling the whole field.
+      queue_clear(&info.pathfinding_queue);
+      _PathfindingStepResults[target] = pSR_repairFailed;
+    }
+
+    return;
+  }
+
+  const size_t maxSteps = _Game.levelInfo.pathfindingSchedule.steps[target];
+
+  if (!maxSteps)
+    return;
+
+  direction_map &writeMap = info.directionMaps[info.write_direction_idx];
+  bool fillCompleted;
+
+  if (_Game.levelInfo.fillEngine == pFE_wavefront && (info.wavefront.active || (!_Game.levelInfo.elevationMasksDirty && wavefront_canBegin(info))))
+    fillCompleted = wavefront_floodfill(info, writeMap, maxSteps);
+  else
+    fillCompleted = floodfill(info.pathfinding_queue, writeMap, _Game.levelInfo.pPathfindingMap, maxSteps);
+
+  if (fillCompleted)
+    _PathfindingStepResults[target] = pSR_fillCompleted;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+constexpr uint32_t _MaxStaleTicksWeight = 64;
+
+// Hands out `pathfinding_schedule::stepsPerTick` based on how many actors are heading to a target and how long its direction map has been out of date.
+// Targets with a current direction map don't get anything.
+void schedulePathfinding()
+{
+  pathfinding_schedule &schedule = _Game.levelInfo.pathfindingSchedule;
+
+  uint64_t weights[ptT_Count - 1];
+  uint64_t weightSum = 0;
+  target_mask restartTargets = 0;
+
+  if (_Game.levelInfo.pathfindingLayout == pL_hierarchical) // Only the queried clusters are detailed, that isn't budgeted.
+  {
+    lsZeroMemory(schedule.steps, LS_ARRAYSIZE(schedule.steps));
+    return;
+  }
+
+  for (size_t i = 0; i < ptT_Count - 1; i++) // Skip ptT_collidable
+  {
+    level_info::resource_info &info = _Game.levelInfo.resources[i];
+    const bool stale = !info.hasReadMap || info.readSeedChangeTotal != info.changeTotal; // Only changes that affect the target count.
+
+    schedule.staleTicks[i] = stale ? schedule.staleTicks[i] + 1 : 0;
+    weights[i] = 0;
+
+    if (!stale || info.fieldComplete || info.directionMaps[0].pDirections == nullptr) // Repairs aren't scheduled, targets that aren't resident don't need anything.
+      continue;
+
+    // The fill in progress was seeded before any of the missing changes happened, so it would only produce the same direction map again.
+    if (info.hasReadMap && info.writeSeedChangeTotal == info.readSeedChangeTotal)
+      restartTargets |= (target_mask)1 << i;
+
+    weights[i] = (1 + (uint64_t)schedule.consumers[i]) * (1 + (uint64_t)lsMin(schedule.staleTicks[i], _MaxStaleTicksWeight));
+    weightSum += weights[i];
+  }
+
+  if (restartTargets)
+  {
+    for (target_mask remaining = restartTargets; remaining; remaining &= remaining - 1)
+    {
+      level_info::resource_info &info = _Game.levelInfo.resources[lsLowestBit(remaining)];
+
+      queue_clear(&info.pathfinding_queue);
+      wavefront_reset(info.wavefront);
+    }
+
+    rebuild_resource_infos(restartTargets);
+  }
+
+  for (size_t i = 0; i < ptT_Count - 1; i++) // Skip ptT_collidable
+    schedule.steps[i] = weights[i] ? lsMax((size_t)1, (size_t)(schedule.stepsPerTick * weights[i] / weightSum)) : 0;
+}
+
+void game_setPathfindingBudget(const size_t stepsPerTick)
+{
+  _Game.levelInfo.pathfindingSchedule.stepsPerTick = stepsPerTick;
+}
+
+void game_setPathfindingEvictionTicks(const uint32_t ticks)
+{
+  _Game.levelInfo.pathfindingSchedule.evictAfterTicks = ticks;
+}
+
+void countPathfindingConsumers()
+{
+  pathfinding_schedule &schedule = _Game.levelInfo.pathfindingSchedule;
+
+  lsZeroMemory(schedule.consumers, LS_ARRAYSIZE(schedule.consumers));
+
+  for (const actor_chunk *pChunk : _Game.actorChunks)
+    for (size_t slot = 0; slot < pChunk->count; slot++)
+      if (pChunk->movement[slot].target < ptT_Count - 1) // Skip ptT_collidable
+        schedule.consumers[pChunk->movement[slot].target]++;
+}
+
+// Nutrient scoring compares distances, repairs need them to find the shortest remaining paths. Everything else only needs directions unless its distances were queried.
+bool target_stores_distances(const size_t target)
+{
+  return (target >= _ptT_nutrient_first && target <= _ptT_nutrient_last) || _Game.levelInfo.pathfindingMode == pUM_repair || _Game.levelInfo.resources[target].distancesQueried;
+}
+
+lsResult alloc_direction_maps(level_info::resource_info &info, const bool withDistances)
+{
+  lsResult result = lsR_Success;
+
+  for (size_t i = 0; i < LS_ARRAYSIZE(info.directionMaps); i++)
+  {
+    if (info.directionMaps[i].pDirections == nullptr)
+    {
+      lsAssert(info.directionMaps[i].pDistances == nullptr);
+      info.directionMaps[i].storage = _Game.levelInfo.tileStorage;
+      LS_ERROR_CHECK(lsAllocZero(&info.directionMaps[i].pDirections, direction_map_byteCount(info.directionMaps[i].storage.count)));
+    }
+
+    if (withDistances && info.directionMaps[i].pDistances == nullptr)
+      LS_ERROR_CHECK(lsAllocZero(&info.directionMaps[i].pDistances, info.directionMaps[i].storage.count));
+  }
+
+epilogue:
+  return result;
+}
+
+void free_direction_maps(level_info::resource_info &info)
+{
+  for (size_t i = 0; i < LS_ARRAYSIZE(info.directionMaps); i++)
+  {
+    lsFreePtr(&info.directionMaps[i].pDirections);
+    lsFreePtr(&info.directionMaps[i].pDistances);
+  }
+}
+
+void evict_resource_info(level_info::resource_info &info)
+{
+  free_direction_maps(info);
+  queue_destroy(&info.pathfinding_queue);
+  list_destroy(&info.repairInvalidated);
+
+  lsFreePtr(&info.wavefront.pFrontier);
+  lsFreePtr(&info.wavefront.pNextFrontier);
+  lsFreePtr(&info.wavefront.pVisited);
+  lsFreePtr(&info.wavefront.pParentRows);
+  info.wavefront.active = false;
+
+  lsFreePtr(&info.pNodeDistances);
+  lsFreePtr(&info.pPreviousNodeDistances);
+  lsFreePtr(&info.pNodeSeedDistances);
+  lsFreePtr(&info.pClusterDetailed);
+  lsFreePtr(&info.pClusterQueried);
+  info.hierarchyGraphVersion = 0;
+
+  info.write_direction_idx = 0;
+  info.fieldComplete = false;
+  info.hasReadMap = false;
+}
+
+// Allocates and starts filling the targets that were queried, frees the ones that nobody needs anymore.
+void updatePathfindingResidency()
+{
+  const pathfinding_schedule &schedule = _Game.levelInfo.pathfindingSchedule;
+  target_mask materializedTargets = 0;
+  target_mask restartedTargets = 0;
+
+  for (size_t i = 0; i < ptT_Count - 1; i++) // Skip ptT_collidable
+  {
+    level_info::resource_info &info = _Game.levelInfo.resources[i];
+
+    if (info.directionMaps[0].pDirections == nullptr)
+    {
+      if (!info.requested)
+        continue;
+
+      if (LS_FAILED(alloc_direction_maps(info, target_stores_distances(i))) || (_Game.levelInfo.pathfindingLayout == pL_hierarchical && (LS_FAILED(lsAllocZero(&info.pClusterDetailed, hierarchy_clusterBitsetWords())) || LS_FAILED(lsAllocZero(&info.pClusterQueried, hierarchy_clusterBitsetWords())))))
+      {
+        evict_resource_info(info); // Try again next tick.
+        continue;
+      }
+
+      info.requested = false;
+      materializedTargets |= (target_mask)1 << i;
+    }
+    else if (schedule.consumers[i] == 0 && schedule.tick - info.lastQueryTick > schedule.evictAfterTicks)
+    {
+      evict_resource_info(info);
+    }
+    else if (target_stores_distances(i) && !info.fieldComplete) // Repairs work on the read direction map, which already has them.
+    {
+      // Hierarchical targets detail their clusters right into the read direction map.
+      const bool hierarchical = _Game.levelInfo.pathfindingLayout == pL_hierarchical;
+      direction_map &map = info.directionMaps[hierarchical ? 1 - info.write_direction_idx : info.write_direction_idx];
+
+      if (map.pDistances != nullptr)
+        continue;
+
+      // The fill in progress didn't record any distances, so it has to start over. The read direction map gets them once it's replaced.
+      if (LS_FAILED(lsAllocZero(&map.pDistances, map.storage.count)))
+      {
+        evict_resource_info(info); // Materialized again on the next query.
+        continue;
+      }
+
+      if (hierarchical)
+      {
+        info.hierarchyGraphVersion = 0; // Clusters are detailed again with distances.
+      }
+      else
+      {
+        wavefront_reset(info.wavefront);
+        queue_clear(&info.pathfinding_queue);
+        restartedTargets |= (target_mask)1 << i;
+      }
+    }
+  }
+
+  if (_Game.levelInfo.pathfindingLayout == pL_hierarchical) // Hierarchical targets start with their first update.
+    materializedTargets = 0;
+
+  if (materializedTargets | restartedTargets)
+    rebuild_resource_infos(materializedTargets | restartedTargets);
+}
+
+// Reads the published direction map of `target` like `game_getPathfindingInfo`, without counting as demand. For checks that mustn't change what the scheduler keeps resident.
+bool pathfinding_peekInfo(const pathfinding_target_type target, const size_t tileIdx, _Out_ pathfinding_info *pInfo)
+{
+  lsAssert(target < ptT_Count - 1); // ptT_collidable doesn't have a direction map.
+  lsAssert(tileIdx < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+
+  const level_info::resource_info &info = _Game.levelInfo.resources[target];
+
+  if (!info.hasReadMap)
+    return false;
+
+  if (_Game.levelInfo.pathfindingLayout == pL_hierarchical && info.pClusterDetailed != nullptr && !hierarchy_bitsetContains(info.pClusterDetailed, hierarchy_tileCluster(tileIdx)))
+    return false;
+
+  const direction_map &readMap = info.directionMaps[1 - info.write_direction_idx];
+  pInfo->dir = direction_map_getDir(readMap, tileIdx);
+  pInfo->dist = direction_map_getDist(readMap, tileIdx);
+
+  return true;
+}
+
+// Returns `false` if the direction map of `target` isn't available (yet). Every query keeps the target resident, the first one materializes it.
+bool game_getPathfindingInfo(const pathfinding_target_type target, const size_t tileIdx, _Out_ pathfinding_info *pInfo)
+{
+  lsAssert(target < ptT_Count - 1); // ptT_collidable doesn't have a direction map.
+  lsAssert(tileIdx < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+
+  level_info::resource_info &info = _Game.levelInfo.resources[target];
+  info.lastQueryTick = _Game.levelInfo.pathfindingSchedule.tick;
+
+  const bool hierarchical = _Game.levelInfo.pathfindingLayout == pL_hierarchical && info.pClusterQueried != nullptr;
+
+  if (hierarchical)
+    hierarchy_bitsetAdd(info.pClusterQueried, hierarchy_tileCluster(tileIdx)); // Detailed with the next update.
+
+  if (!info.hasReadMap)
+  {
+    info.requested = true;
+    return false;
+  }
+
+  if (!pathfinding_peekInfo(target, tileIdx, pInfo))
+    return false;
+
+  // Actors walk towards the tile the path came from, request its cluster before they get there.
+  if (hierarchical && pInfo->dir >= d_topRight && pInfo->dir <= d_topLeft)
+    hierarchy_bitsetAdd(info.pClusterQueried, hierarchy_tileCluster(tileNeighbor(tileIdx, direction_opposite(pInfo->dir))));
+
+  return true;
+}
+
+bool game_canReachTarget(const pathfinding_target_type target, const size_t tileIdx)
+{
+  lsAssert(target < ptT_Count - 1); // ptT_collidable is never part of a component.
+  lsAssert(tileIdx < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+
+  if (_Game.levelInfo.tileComponentsDirty && LS_FAILED(relabelTileComponents()))
+    return true; // We can't tell, so don't rule anything out.
+
+  const uint32_t component = _Game.levelInfo.pTileComponents[tileIdx];
+
+  return component != NoTileComponent && (list_get(&_Game.levelInfo.tileComponents, component)->targets & ((target_mask)1 << target));
+}
+
+bool game_getTargetDistance(const pathfinding_target_type target, const size_t tileIdx, _Out_ uint32_t *pDist, _Out_opt_ bool *pApproximate /* = nullptr */)
+{
+  level_info::resource_info &info = _Game.levelInfo.resources[target];
+  info.distancesQueried = true;
+
+  pathfinding_info pathInfo;
+
+  if (!game_getPathfindingInfo(target, tileIdx, &pathInfo) || info.directionMaps[1 - info.write_direction_idx].pDistances == nullptr)
+    return false;
+
+  *pDist = (pathInfo.dir == d_unreachable || pathInfo.dir == d_unfillable) ? UnreachableTargetDistance : pathInfo.dist;
+
+  if (pApproximate != nullptr)
+    *pApproximate = _Game.levelInfo.pathfindingLayout == pL_hierarchical;
+
+  return true;
+}
+
+bool game_getNextStepTile(const pathfinding_target_type target, const size_t tileIdx, _Out_ size_t *pNextTileIdx)
+{
+  pathfinding_info pathInfo;
+
+  if (!game_getPathfindingInfo(target, tileIdx, &pathInfo) || pathInfo.dir == d_unreachable || pathInfo.dir == d_unfillable)
+    return false;
+
+  // The stored direction is the one the tile was entered from, so the path continues the opposite way.
+  *pNextTileIdx = pathInfo.dir == d_atDestination ? tileIdx : tileNeighbor(tileIdx, direction_opposite(pathInfo.dir));
+  return true;
+}
+
+bool game_getBestTarget(const weighted_target *pTargets, const size_t targetCount, const size_t tileIdx, _Out_ size_t *pBestTargetIndex)
+{
+  bool found = false;
+  int64_t bestScore = 0;
+
+  for (size_t i = 0; i < targetCount; i++)
+  {
+    uint32_t dist;
+
+    if (!game_getTargetDistance(pTargets[i].target, tileIdx, &dist) || dist == UnreachableTargetDistance)
+      continue;
+
+    const int64_t score = pTargets[i].weight - (int64_t)dist;
+
+    if (!found || score > bestScore)
+    {
+      found = true;
+      bestScore = score;
+      *pBestTargetIndex = i;
+    }
+  }
+
+  return found;
+}
+
+void game_getTargetDistances(const pathfinding_target_type *pTargets, const size_t targetCount, const size_t *pTileIndices, const size_t tileCount, _Out_ uint32_t *pDistances, _Out_opt_ bool *pApproximate /* = nullptr */)
+{
+  if (pApproximate != nullptr)
+    *pApproximate = _Game.levelInfo.pathfindingLayout == pL_hierarchical;
+
+  for (size_t t = 0; t < targetCount; t++)
+  {
+    level_info::resource_info &info = _Game.levelInfo.resources[pTargets[t]];
+    const direction_map &readMap = info.directionMaps[1 - info.write_direction_idx];
+
+    // Hierarchical targets have to be checked cluster by cluster, everything else can be looked up directly.
+    if (_Game.levelInfo.pathfindingLayout == pL_hierarchical || !info.hasReadMap || readMap.pDistances == nullptr)
+    {
+      for (size_t i = 0; i < tileCount; i++)
+        if (!game_getTargetDistance(pTargets[t], pTileIndices[i], &pDistances[i * targetCount + t]))
+          pDistances[i * targetCount + t] = UnreachableTargetDistance;
+
+      continue;
+    }
+
+    info.lastQueryTick = _Game.levelInfo.pathfindingSchedule.tick;
+
+    for (size_t i = 0; i < tileCount; i++)
+    {
+      lsAssert(pTileIndices[i] < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+
+      const direction dir = direction_map_getDir(readMap, pTileIndices[i]);
+      pDistances[i * targetCount + t] = (dir == d_unreachable || dir == d_unfillable) ? UnreachableTargetDistance : direction_map_getDist(readMap, pTileIndices[i]);
+    }
+  }
+}
+
+void updateFloodfill()
+{
+  target_mask rebuildTargets = 0;
+
+  if (_Game.levelInfo.fillEngine == pFE_wavefront && _Game.levelInfo.elevationMasksDirty)
+    wavefront_updateElevationMasks(); // Fills fall back to the queue until this succeeds.
+
+  _Game.levelInfo.pathfindingSchedule.tick++;
+
+  countPathfindingConsumers();
+  updatePathfindingResidency();
+
+  // Tile changes that couldn't be journaled can't be repaired.
+  if (_Game.levelInfo.unjournaledTargets && _Game.levelInfo.pathfindingLayout == pL_flat)
+  {
+    target_mask restartTargets = 0;
+
+    for (target_mask remaining = _Game.levelInfo.unjournaledTargets; remaining; remaining &= remaining - 1)
+    {
+      level_info::resource_info &info = _Game.levelInfo.resources[lsLowestBit(remaining)];
+
+      if (info.directionMaps[0].pDirections == nullptr) // Not resident: will start with a fresh fill.
+        continue;
+
+      info.fieldComplete = false;
+      queue_clear(&info.pathfinding_queue);
+      wavefront_reset(info.wavefront);
+      restartTargets |= (target_mask)1 << lsLowestBit(remaining);
+    }
+
+    if (restartTargets)
+      rebuild_resource_infos(restartTargets);
+  }
+
+  _Game.levelInfo.unjournaledTargets = 0; // Hierarchical targets are detailed again once the entrance graph was rebuilt.
+
+  if (_Game.levelInfo.pathfindingLayout == pL_hierarchical)
+    hierarchy_update();
+
+  schedulePathfinding();
+  parallel_for(ptT_Count - 1, 1, [](const size_t begin, const size_t end) // Skip ptT_collidable
+    {
+      for (size_t i = begin; i < end; i++)
+        update_resource_info(i);
+    });
+
+  // Tick barrier: publish the results of all targets.
+  for (size_t i = 0; i < ptT_Count - 1; i++) // Skip ptT_collidable
+  {
+    level_info::resource_info &info = _Game.levelInfo.resources[i];
+
+    switch (_PathfindingStepResults[i])
+    {
+    case pSR_repairFailed:
+    {
+      info.fieldComplete = false;
+      rebuildTargets |= (target_mask)1 << i;
+      break;
+    }
+    case pSR_fillCompleted:
+    {
+      lsAssert(!info.pathfinding_queue.count);
+
+      info.write_direction_idx = 1 - info.write_direction_idx;
+      info.readSeedChangeTotal = info.writeSeedChangeTotal;
+      info.hasReadMap = true;
+
+      // The previous read direction map may not have stored distances.
+      if (target_stores_distances(i) && info.directionMaps[info.write_direction_idx].pDistances == nullptr && LS_FAILED(lsAllocZero(&info.directionMaps[info.write_direction_idx].pDistances, info.directionMaps[info.write_direction_idx].storage.count)))
+      {
+        evict_resource_info(info); // Materialized again on the next query.
+        break;
+      }
+
+      if (_Game.levelInfo.pathfindingMode == pUM_repair)
+        info.fieldComplete = true; // Changes made while filling are repaired next tick.
+      else if (info.readSeedChangeTotal != info.changeTotal) // Otherwise `schedulePathfinding` restarts it once a change affects it.
+        rebuildTargets |= (target_mask)1 << i;
+
+      break;
+    }
+    case pSR_hierarchyUpdated:
+    {
+      info.hasReadMap = true;
+      break;
+    }
+    default:
+    {
+      break;
+    }
+    }
+  }
+
+  if (rebuildTargets)
+    rebuild_resource_infos(rebuildTargets);
+
+  // Drop the changes that every field has already caught up on.
+  {
+    pathfinding_hierarchy &hierarchy = _Game.levelInfo.pathfindingHierarchy;
+    const bool hierarchical = _Game.levelInfo.pathfindingLayout == pL_hierarchical;
+
+    if (!hierarchical)
+      hierarchy.processedChangeCount = _Game.levelInfo.tileChanges.count;
+
+    size_t processedCount = hierarchy.processedChangeCount;
+
+    for (size_t i = 0; i < ptT_Count - 1; i++) // Skip ptT_collidable
+    {
+      if (hierarchical || _Game.levelInfo.resources[i].directionMaps[0].pDirections == nullptr) // Not resident: will start with a fresh fill. Hierarchical targets get their changes from the hierarchy.
+        _Game.levelInfo.resources[i].processedChangeCount = _Game.levelInfo.tileChanges.count;
+
+      processedCount = lsMin(processedCount, _Game.levelInfo.resources[i].processedChangeCount);
+    }
+
+    if (processedCount > 0)
+    {
+      lsMemmove(_Game.levelInfo.tileChanges.pValues, _Game.levelInfo.tileChanges.pValues + processedCount, _Game.levelInfo.tileChanges.count - processedCount);
+      _Game.levelInfo.tileChanges.count -= processedCount;
+      hierarchy.processedChangeCount -= processedCount;
+
+      for (size_t i = 0; i < ptT_Count - 1; i++) // Skip ptT_collidable
+        _Game.levelInfo.resources[i].processedChangeCount -= processedCount;
+    }
+  }
+}
+
+void game_setPathfindingMode(const pathfinding_update_mode mode)
+{
+  if (_Game.levelInfo.pathfindingMode == mode)
+    return;
+
+  _Game.levelInfo.pathfindingMode = mode;
+
+  // Completed fields are kept readable until the new fill replaces them.
+  target_mask rebuildTargets = 0;
+
+  for (size_t i = 0; i < ptT_Count - 1; i++) // Skip ptT_collidable
+  {
+    level_info::resource_info &info = _Game.levelInfo.resources[i];
+
+    if (info.directionMaps[0].pDirections == nullptr) // Not resident: will be allocated with the right layout.
+      continue;
+
+    if (mode == pUM_rebuild)
+    {
+      if (info.fieldComplete)
+      {
+        info.fieldComplete = false;
+        rebuildTargets |= (target_mask)1 << i;
+      }
+
+      if (!target_stores_distances(i)) // Fills skip missing distances, so these can go right away.
+        for (size_t j = 0; j < LS_ARRAYSIZE(info.directionMaps); j++)
+          lsFreePtr(&info.directionMaps[j].pDistances);
+    }
+
+    // Targets that need distances now are restarted by `updatePathfindingResidency`. Repairs only start once a fill with distances completed.
+  }
+
+  if (rebuildTargets)
+    rebuild_resource_infos(rebuildTargets);
+}
+
+void game_setPathfindingLayout(const pathfinding_layout layout)
+{
+  if (_Game.levelInfo.pathfindingLayout == layout)
+    return;
+
+  _Game.levelInfo.pathfindingLayout = layout;
+
+  // Direction maps of the other layout can't be continued, targets are materialized again on their next query.
+  for (size_t i = 0; i < ptT_Count - 1; i++) // Skip ptT_collidable
+    if (_Game.levelInfo.resources[i].directionMaps[0].pDirections != nullptr)
+      evict_resource_info(_Game.levelInfo.resources[i]);
+
+  if (layout == pL_flat)
+    hierarchy_destroy();
+  else
+    _Game.levelInfo.pathfindingHierarchy.graphDirty = true;
+}
+
+void game_setTileStorageLayout(const tile_storage_layout layout)
+{
+  if (_Game.levelInfo.tileStorage.layout == layout)
+    return;
+
+  _Game.levelInfo.tileStorage = tile_storage_create(layout, _Game.levelInfo.map_size.x, _Game.levelInfo.map_size.y);
+
+  // Direction maps can't be continued in another layout, targets are materialized again on their next query.
+  for (size_t i = 0; i < ptT_Count - 1; i++) // Skip ptT_collidable
+    if (_Game.levelInfo.resources[i].directionMaps[0].pDirections != nullptr)
+      evict_resource_info(_Game.levelInfo.resources[i]);
+}
+
+lsResult game_fillDirectionMap(const pathfinding_target_type target)
+{
+  lsResult result = lsR_Success;
+
+  LS_ERROR_IF(target >= ptT_Count - 1 || _Game.levelInfo.pathfindingLayout != pL_flat, lsR_InvalidParameter); // Skip ptT_collidable
+
+  {
+    level_info::resource_info &info = _Game.levelInfo.resources[target];
+    info.lastQueryTick = _Game.levelInfo.pathfindingSchedule.tick;
+
+    if (info.directionMaps[0].pDirections == nullptr)
+    {
+      LS_ERROR_CHECK(alloc_direction_maps(info, target_stores_distances(target)));
+      info.requested = false;
+    }
+
+    wavefront_reset(info.wavefront);
+    queue_clear(&info.pathfinding_queue);
+    info.fieldComplete = false;
+
+    rebuild_resource_infos((target_mask)1 << target);
+
+    // The empty queue completes the fill on the next tick, which publishes it like any other.
+    floodfill(info.pathfinding_queue, info.directionMaps[info.write_direction_idx], _Game.levelInfo.pPathfindingMap, (size_t)-1);
+  }
+
+epilogue:
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+size_t worldPosToTileIndex(const vec2f pos)
+{
+  const float_t x_even = lsFloor(lsClamp(pos.x, 0.f, (float_t)_Game.levelInfo.map_size.x) + 0.5f);
+  const float_t y_even = lsFloor(lsClamp(pos.y, 0.f, (float_t)_Game.levelInfo.map_size.y) * 0.5f + 0.5f) * 2.f;
+
+  const float_t x_odd = lsFloor(lsClamp(pos.x, 0.f, (float_t)_Game.levelInfo.map_size.x)); // x_even is shifted by -0.5 compared to the world pos.
+  const float_t y_odd = lsFloor(lsClamp((pos.y - 1) * 0.5f, 0.f, (float_t)_Game.levelInfo.map_size.y) + 0.5f) * 2.f + 1.f;
+
+  //const float_t dist_even = lsAbs((x_even + y_even) - (pos.x + pos.y));
+  //const float_t dist_odd = lsAbs((x_odd + 0.5f + y_odd) - (pos.x + pos.y));
+
+  const float_t dist_even = vec2f(x_even - pos.x, y_even - pos.y).LengthSquared();
+  const float_t dist_odd = vec2f(x_odd - (pos.x - 0.5f), y_odd - pos.y).LengthSquared();
+
+  // Combining in integer space, as `float_t` can't represent every tile index on large maps.
+  if (dist_even < dist_odd)
+    return (size_t)y_even * _Game.levelInfo.map_size.x + (size_t)x_even;
+  else
+    return (size_t)y_odd * _Game.levelInfo.map_size.x + (size_t)x_odd;
+}
+
+vec2f tileIndexToWorldPos(const size_t tileIndex)
+{
+  const size_t x_center = tileIndex % _Game.levelInfo.map_size.x;
+  const size_t y_center = tileIndex / _Game.levelInfo.map_size.x;
+
+  vec2f tilePos = vec2f(vec2s(x_center, y_center));
+
+  if (y_center & 1) // every second row is shifted by + 0.5
+    tilePos.x += 0.5f;
+
+  return tilePos;
+}
+
+static size_t r = 0;
+
+// Picks the heading of every movement actor. Stays scalar, as the direction lookup depends on the target of each actor and only rarely changes the heading.
+void movementActor_steer()
+{
+  r = (r + 1) & 63;
+
+  movement_kinematics &kinematics = _Game.movementKinematics;
+
+  for (actor_chunk *pChunk : _Game.actorChunks)
+  {
+    for (size_t slot = 0; slot < pChunk->count; slot++)
+    {
+      movement_actor *pActor = &pChunk->movement[slot];
+      const size_t i = pChunk->entityIndex[slot];
+
+      // Reset lastTile every so often to handle map changes.
+      if ((i & 63) == r)
+        kinematics.pLastTickTileIdx[i] = (uint32_t)(_Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y * 0.5);
+
+      pActor->atDestinationLastTick = pActor->atDestination; // Has to be at this position, as it otherwise wouldn't catch the value changing from the actor being on the right tile already but with a different target last tick. It's therefor completly useless for this function!
+      kinematics.pFlags[i] &= (uint8_t)~mF_moving;
+
+      const size_t currentTileIdx = kinematics.pTileIdx[i];
+      lsAssert(currentTileIdx != 0 && currentTileIdx < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+
+      if (pActor->isWaiting)
+      {
+        if (pActor->ticksToWait)
+          pActor->ticksToWait--;
+        else
+          pActor->isWaiting = false;
+      }
+      else if (pActor->target < ptT_Count - 1) // Actors without a target stay where they are.
+      {
+        pathfinding_info pathInfo;
+
+        if (!game_getPathfindingInfo(pActor->target, currentTileIdx, &pathInfo)) // Wait until the direction map is available.
+          continue;
+
+        const direction currentTileDirectionType = pathInfo.dir;
+        const vec2f pos = movementActor_pos(i);
+
+        lsAssert(pos.x > 0 && pos.x < _Game.levelInfo.map_size.x && pos.y > 0 && pos.y < _Game.levelInfo.map_size.y);
+
+        if (currentTileDirectionType == d_unreachable)
+        {
+          continue;
+        }
+        else if (currentTileDirectionType == d_atDestination)
+        {
+          pActor->atDestination = true;
+          kinematics.pDirectionX[i] = kinematics.pDirectionY[i] = 0;
+          continue;
+        }
+
+        vec2f direction = vec2f(kinematics.pDirectionX[i], kinematics.pDirectionY[i]);
+
+        if (currentTileIdx != kinematics.pLastTickTileIdx[i])
+        {
+          if (currentTileDirectionType == d_unfillable)
+          {
+            direction = (tileIndexToWorldPos(kinematics.pLastTickTileIdx[i]) - pos).Normalize();
+          }
+          else
+          {
+            const vec2f tilePos = tileIndexToWorldPos(currentTileIdx);
+            const vec2f nonNormalizedDir = (tilePos - pos);
+            if (nonNormalizedDir != vec2f(0))
+              direction = nonNormalizedDir.Normalize();
+
+            kinematics.pFlags[i] |= mF_enteredDifferentTileLastTick;
+          }
+        }
+        else if (kinematics.pFlags[i] & mF_enteredDifferentTileLastTick)
+        {
+          const vec2f directionLut[6] = { vec2f(-0.5, 1), vec2f(-1, 0), vec2f(-0.5, -1), vec2f(0.5, -1), vec2f(1, 0), vec2f(0.5, 1) };
+          const vec2f tilePos = tileIndexToWorldPos(currentTileIdx);
+          const vec2f destinationPos = tilePos + directionLut[currentTileDirectionType - 1];
+
+          lsAssert(destinationPos - pos != vec2f(0));
+          direction = (destinationPos - pos).Normalize();
+          kinematics.pFlags[i] &= (uint8_t)~mF_enteredDifferentTileLastTick;
+        }
+
+        kinematics.pDirectionX[i] = direction.x;
+        kinematics.pDirectionY[i] = direction.y;
+        kinematics.pFlags[i] |= mF_moving;
+      }
+
+      kinematics.pLastTickTileIdx[i] = (uint32_t)currentTileIdx;
+    }
+  }
+}
+
+// `worldPosToTileIndex` for `MovementLaneCount` positions at once, matching it lane by lane.
+FORCEINLINE void worldPosToTileIndexLanes(const __m128 x, const __m128 y, uint32_t *pTileIdx)
+{
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 half = _mm_set1_ps(0.5f);
+  const __m128 mapWidth = _mm_set1_ps((float_t)_Game.levelInfo.map_size.x);
+  const __m128 mapHeight = _mm_set1_ps((float_t)_Game.levelInfo.map_size.y);
+
+  // All inputs are clamped to be positive, so truncating equals flooring.
+  const __m128 clampedX = _mm_min_ps(_mm_max_ps(x, zero), mapWidth);
+
+  const __m128i xEvenIdx = _mm_cvttps_epi32(_mm_add_ps(clampedX, half));
+  const __m128i yEvenIdx = _mm_slli_epi32(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_min_ps(_mm_max_ps(y, zero), mapHeight), half), half)), 1);
+  const __m128i xOddIdx = _mm_cvttps_epi32(clampedX);
+  const __m128i yOddIdx = _mm_add_epi32(_mm_slli_epi32(_mm_cvttps_epi32(_mm_add_ps(_mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(y, _mm_set1_ps(1.f)), half), zero), mapHeight), half)), 1), _mm_set1_epi32(1));
+
+  const __m128 evenDx = _mm_sub_ps(_mm_cvtepi32_ps(xEvenIdx), x);
+  const __m128 evenDy = _mm_sub_ps(_mm_cvtepi32_ps(yEvenIdx), y);
+  const __m128 oddDx = _mm_sub_ps(_mm_cvtepi32_ps(xOddIdx), _mm_sub_ps(x, half));
+  const __m128 oddDy = _mm_sub_ps(_mm_cvtepi32_ps(yOddIdx), y);
+
+  const __m128 distEven = _mm_add_ps(_mm_mul_ps(evenDx, evenDx), _mm_mul_ps(evenDy, evenDy));
+  const __m128 distOdd = _mm_add_ps(_mm_mul_ps(oddDx, oddDx), _mm_mul_ps(oddDy, oddDy));
+  const __m128i useEven = _mm_castps_si128(_mm_cmplt_ps(distEven, distOdd));
+
+  alignas(16) uint32_t tileX[MovementLaneCount];
+  alignas(16) uint32_t tileY[MovementLaneCount];
+  _mm_store_si128(reinterpret_cast<__m128i *>(tileX), _mm_or_si128(_mm_and_si128(useEven, xEvenIdx), _mm_andnot_si128(useEven, xOddIdx)));
+  _mm_store_si128(reinterpret_cast<__m128i *>(tileY), _mm_or_si128(_mm_and_si128(useEven, yEvenIdx), _mm_andnot_si128(useEven, yOddIdx)));
+
+  // Combining in integer space, as `float_t` can't represent every tile index on large maps.
+  for (size_t lane = 0; lane < MovementLaneCount; lane++)
+    pTileIdx[lane] = (uint32_t)(tileY[lane] * _Game.levelInfo.map_size.x + tileX[lane]);
+}
+
+// Refreshes the tile index column of all movement actors.
+void movementActor_updateTileIndices()
+{
+  movement_kinematics &kinematics = _Game.movementKinematics;
+
+  for (size_t i = 0; i < kinematics.count; i += MovementLaneCount)
+    worldPosToTileIndexLanes(_mm_loadu_ps(kinematics.pPosX + i), _mm_loadu_ps(kinematics.pPosY + i), kinematics.pTileIdx + i);
+}
+
+// Moves every `mF_moving` actor along its direction and finds the tile it ends up on, `MovementLaneCount` actors at a time.
+// This is the only place actor positions change during a tick, so every system afterwards reads `pTileIdx` instead of rounding the position again.
+void movementActor_integrate()
+{
+  movement_kinematics &kinematics = _Game.movementKinematics;
+
+  const __m128 step = _mm_set1_ps(0.1f);
+  const __m128i movingBit = _mm_set1_epi32(mF_moving);
+
+  for (size_t i = 0; i < kinematics.count; i += MovementLaneCount)
+  {
+    uint32_t flags;
+    memcpy(&flags, kinematics.pFlags + i, sizeof(flags));
+    static_assert(sizeof(flags) == MovementLaneCount * sizeof(kinematics.pFlags[0]));
+
+    __m128i laneFlags = _mm_cvtsi32_si128((int32_t)flags);
+    laneFlags = _mm_unpacklo_epi16(_mm_unpacklo_epi8(laneFlags, _mm_setzero_si128()), _mm_setzero_si128());
+    const __m128 moving = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(laneFlags, movingBit), movingBit));
+
+    __m128 x = _mm_loadu_ps(kinematics.pPosX + i);
+    __m128 y = _mm_loadu_ps(kinematics.pPosY + i);
+
+    x = _mm_add_ps(x, _mm_and_ps(moving, _mm_mul_ps(step, _mm_loadu_ps(kinematics.pDirectionX + i))));
+    y = _mm_add_ps(y, _mm_and_ps(moving, _mm_mul_ps(step, _mm_loadu_ps(kinematics.pDirectionY + i))));
+
+    _mm_storeu_ps(kinematics.pPosX + i, x);
+    _mm_storeu_ps(kinematics.pPosY + i, y);
+
+    worldPosToTileIndexLanes(x, y, kinematics.pTileIdx + i);
+  }
+}
+
+void movementActor_move()
+{
+  movementActor_steer();
+  movementActor_integrate();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+  requires (std::is_integral_v<T> && (sizeof(T) < sizeof(int64_t) || std::is_same_v<T, int64_t>))
+inline T modify_with_clamp(T &value, const int64_t diff, const T min = lsMinValue<T>(), const T max = lsMaxValue<T>())
+{
+  const int64_t val = (int64_t)value + diff;
+  const T prevVal = value;
+  value = (T)lsClamp<int64_t>(val, min, max);
+  return (T)lsAbs((int64_t)value - prevVal);
+}
+
+// Sets `*pChanged` to whether the tile was `expectedCurrentType` and has been changed to `targetType`.
+lsResult change_tile_to(const resource_type targetType, const resource_type expectedCurrentType, const size_t tileIdx, const uint8_t count, _Out_ bool *pChanged)
+{
+  // TODO: if we can conclude from the resource_type to the ptt we could add an assert, that the ptt is `at_dest` in the pathfindingMap to assert, that the `expectedType` isn't nonsense
+
+  lsResult result = lsR_Success;
+
+  lsAssert(tileIdx >= 0 && tileIdx < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+
+  *pChanged = false;
+
+  if (_Game.levelInfo.pGameplayMap[tileIdx].tileType == expectedCurrentType)
+  {
+    // TODO what free assert did coc talk about?
+    result = setGameplayTile(tileIdx, targetType, count);
+    *pChanged = LS_SUCCESS(result) || _Game.levelInfo.pGameplayMap[tileIdx].tileType != expectedCurrentType; // Changes that couldn't be journaled have still happened.
+    LS_ERROR_CHECK(result);
+  }
+
+epilogue:
+  return result;
+}
+
+// `*pAdded` is the amount that was actually added, it's also set if the change couldn't be journaled, as the tile has changed regardless.
+lsResult add_to_market_tile(const resource_type resource, const int16_t amount, const size_t tileIdx, _Out_ uint8_t *pAdded)
+{
+  lsAssert(tileIdx >= 0 && tileIdx < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+  lsAssert(resource < tT_count);
+
+  gameplay_element *pTile = &_Game.levelInfo.pGameplayMap[tileIdx];
+
+  lsAssert(pTile->tileType == tT_market);
+  lsAssert(pTile->multiResourceCountIndex > -1);
+
+  const tile_snapshot previous = getTileSnapshot(tileIdx);
+  *pAdded = multi_resource_modify(pTile->multiResourceCountIndex, resource, amount);
+
+  return journalTileChange(tileIdx, previous);
+}
+
+// `*pTaken` is the amount that was actually taken, it's also set if the change couldn't be journaled, as the tile has changed regardless.
+lsResult get_from_tile(const size_t tileIdx, const resource_type resource, const uint8_t amount, _Out_ uint8_t *pTaken)
+{
+  lsAssert(tileIdx >= 0 && tileIdx < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+  lsAssert(resource < tT_count);
+
+  gameplay_element *pTile = &_Game.levelInfo.pGameplayMap[tileIdx];
+
+  if (pTile->multiResourceCountIndex == -1)
+  {
+    lsAssert(pTile->tileType == resource);
+
+    if (gameplay_element_maxCount(*pTile) == 1) // Tiles without a count (e.g. water) don't run out.
+    {
+      *pTaken = amount;
+      return lsR_Success;
+    }
+    
+    const tile_snapshot previous = getTileSnapshot(tileIdx);
+    *pTaken = modify_with_clamp(pTile->resourceCount, -amount);
+
+    return journalTileChange(tileIdx, previous);
+  }
+  else
+  {
+    lsAssert(pTile->tileType == tT_market);
+    const tile_snapshot previous = getTileSnapshot(tileIdx);
+    *pTaken = multi_resource_modify(pTile->multiResourceCountIndex, resource, -(int64_t)amount);
+
+    return journalTileChange(tileIdx, previous);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+lsResult execute_action(const drop_off_action &actn, actor *pActor, const size_t tileIdx, _Out_ action_result *pResult)
+{
+  lsResult result = lsR_Success;
+
+  gameplay_element *pElement = &_Game.levelInfo.pGameplayMap[tileIdx];
+
+  *pResult = aR_failed;
+
+  if (pElement->tileType != actn.destTileType)
+    goto epilogue;
+
+  // drop off
+  if (actn.destTileType == tT_market)
+  {
+    uint8_t added = 0;
+    result = add_to_market_tile(actn.item, actn.amount, tileIdx, &added);
+    modify_with_clamp(pActor->inventory[actn.item], -added); // The market has the items even if the change couldn't be journaled.
+    LS_ERROR_CHECK(result);
+  }
+  else
+  {
+    const tile_snapshot previous = getTileSnapshot(tileIdx);
+    modify_with_clamp(pElement->resourceCount, modify_with_clamp(pActor->inventory[actn.item], -actn.amount), uint8_t(0), gameplay_element_maxCount(*pElement));
+    LS_ERROR_CHECK(journalTileChange(tileIdx, previous));
+  }
+
+  *pResult = aR_done;
+
+epilogue:
+  return result;
+}
+
+lsResult execute_action(const get_action &actn, actor *pActor, const size_t tileIdx, _Out_ action_result *pResult)
+{
+  lsResult result = lsR_Success;
+  uint8_t returnedAmount = 0;
+
+  *pResult = aR_failed;
+
+  if (_Game.levelInfo.pGameplayMap[tileIdx].tileType != actn.item && _Game.levelInfo.pGameplayMap[tileIdx].tileType != tT_market)
+    goto epilogue;
+
+  result = get_from_tile(tileIdx, actn.item, actn.amount, &returnedAmount);
+  modify_with_clamp(pActor->inventory[actn.item], returnedAmount); // Taken from the tile even if the change couldn't be journaled.
+  LS_ERROR_CHECK(result);
+
+  if (returnedAmount)
+    *pResult = aR_done;
+
+epilogue:
+  return result;
+}
+
+lsResult execute_action(const change_tile_action &actn, actor *pActor, const size_t tileIdx, _Out_ action_result *pResult)
+{
+  lsResult result = lsR_Success;
+  bool changed = false;
+
+  *pResult = aR_failed;
+
+  if (actn.consumedItem != tT_count && pActor->inventory[actn.consumedItem] == 0)
+  {
+    *pResult = aR_missing_item;
+    goto epilogue;
+  }
+
+  {
+    const uint8_t amount = actn.amount == change_tile_action::KeepResourceCount ? _Game.levelInfo.pGameplayMap[tileIdx].resourceCount : actn.amount;
+    result = change_tile_to(actn.targetTileType, actn.currentTileType, tileIdx, amount, &changed);
+  }
+
+  if (!changed)
+    goto epilogue;
+
+  if (actn.consumedItem != tT_count)
+    pActor->inventory[actn.consumedItem]--;
+
+  if (actn.producedItem != tT_count)
+    modify_with_clamp(pActor->inventory[actn.producedItem], 1);
+
+  LS_ERROR_CHECK(result); // The tile has changed, so the inventory had to change as well.
+
+  *pResult = aR_done;
+
+epilogue:
+  return result;
+}
+
+lsResult execute_action(const plant_action &, actor *, const size_t tileIdx, _Out_ action_result *pResult)
+{
+  lsResult result = lsR_Success;
+  bool changed = false;
+
+  *pResult = aR_failed;
+
+  if (_Game.levelInfo.pGameplayMap[tileIdx].tileType != tT_soil)
+    goto epilogue;
+
+  {
+    pathfinding_target_type plant = ptT_Count;
+
+    for (uint8_t i = _ptT_nutrient_sources_first; i <= _ptT_nutrient_sources_last; i++)
+    {
+      if (!game_canReachTarget((pathfinding_target_type)i, tileIdx)) // Plants that aren't available yet are skipped.
+      {
+        plant = (pathfinding_target_type)i; // TODO: Maybe we want to just increment the last plant and if its already there we choose another one that isn't
+        break;
+      }
+    }
+
+    if (plant == ptT_Count)
+      plant = (pathfinding_target_type)(lsGetRand(_Game.levelInfo.gameplaySeed) % (_ptT_nutrient_sources_last - _ptT_nutrient_sources_first) + _ptT_nutrient_sources_first);
+
+    constexpr uint8_t AddedAmountToPlant = 12;
+
+    const resource_type resource = (resource_type)plant;
+    lsAssert(resource >= _tile_type_food_resources_first && resource <= _tile_type_food_resources_last);
+
+    LS_ERROR_CHECK(change_tile_to(resource, tT_soil, tileIdx, AddedAmountToPlant, &changed));
+  }
+
+  if (changed)
+    *pResult = aR_done;
+
+epilogue:
+  return result;
+}
+
+lsResult execute_action(const light_fire_action &actn, actor *pActor, const size_t tileIdx, _Out_ action_result *pResult)
+{
+  lsResult result = lsR_Success;
+
+  gameplay_element *pElement = &_Game.levelInfo.pGameplayMap[tileIdx];
+
+  *pResult = aR_failed;
+
+  if (pElement->tileType != tT_fire_pit)
+    goto epilogue;
+
+  if (pElement->resourceCount <= actn.woodPerFire && pActor->inventory[tT_wood] < actn.woodPerFire) // TODO: A fire should propably not only loose wood, when someone was there, but just slowly over time or when extinguished.
+  {
+    *pResult = aR_missing_item;
+    goto epilogue;
+  }
+
+  {
+    const tile_snapshot previous = getTileSnapshot(tileIdx);
+
+    if (pElement->resourceCount <= actn.woodPerFire)
+    {
+      pActor->inventory[tT_wood] -= actn.woodPerFire;
+      modify_with_clamp(pElement->resourceCount, actn.woodPerFire, (uint8_t)(0), gameplay_element_maxCount(*pElement));
+    }
+
+    pElement->tileType = tT_fire; // No usage of `change_tile_to` because of check above. Actually okay to just change the tileType as we want to keep `count` and the maximum counts of `tT_fire` and `tT_fire_pit` are the same.
+    LS_ERROR_CHECK(journalTileChange(tileIdx, previous));
+  }
+
+  *pResult = aR_done;
+
+epilogue:
+  return result;
+}
+
+lsResult execute_action(const harvest_action &actn, actor *pActor, const size_t tileIdx, _Out_ action_result *pResult)
+{
+  lsResult result = lsR_Success;
+
+  gameplay_element *pElement = &_Game.levelInfo.pGameplayMap[tileIdx];
+
+  *pResult = aR_failed;
+
+  if (pElement->tileType < _tile_type_food_resources_first || pElement->tileType > _tile_type_food_resources_last || pElement->resourceCount == 0)
+    goto epilogue;
+
+  {
+    const resource_type plant = pElement->tileType;
+    uint8_t harvested = 0;
+    result = get_from_tile(tileIdx, plant, actn.amount, &harvested);
+    modify_with_clamp(pActor->inventory[plant], harvested); // Taken from the tile even if the change couldn't be journaled.
+    LS_ERROR_CHECK(result);
+  }
+
+  if (pElement->resourceCount == 0)
+  {
+    const tile_snapshot previous = getTileSnapshot(tileIdx);
+    *pElement = gameplay_element(tT_soil, 1); // no usage of `change_tile_to` due to earlier check of `resource_type`
+    LS_ERROR_CHECK(journalTileChange(tileIdx, previous));
+  }
+
+  *pResult = aR_done;
+
+epilogue:
+  return result;
+}
+
+lsResult execute_action(const cook_action &actn, actor *pActor, const size_t tileIdx, _Out_ action_result *pResult)
+{
+  lsResult result = lsR_Success;
+
+  gameplay_element *pElement = &_Game.levelInfo.pGameplayMap[tileIdx];
+
+  *pResult = aR_failed;
+
+  if (pElement->tileType != pActor->meal || pElement->resourceCount == gameplay_element_maxCount(*pElement))
+    goto epilogue;
+
+  {
+    const tile_snapshot previous = getTileSnapshot(tileIdx);
+    modify_with_clamp(pElement->resourceCount, actn.amount, uint8_t(0), gameplay_element_maxCount(*pElement));
+    result = journalTileChange(tileIdx, previous); // The meal has been cooked even if the change couldn't be journaled.
+  }
+
+  for (size_t i = 0; i < LS_ARRAYSIZE(IngridientAmountPerFood[0]); i++)
+  {
+    lsAssert(pActor->inventory[_tile_type_food_resources_first + i] >= IngridientAmountPerFood[pActor->meal - _tile_type_food_first][i]);
+    pActor->inventory[_tile_type_food_resources_first + i] -= IngridientAmountPerFood[pActor->meal - _tile_type_food_first][i];
+  }
+
+  // change to next food item
+  pActor->meal = getNextCookItem(pActor->meal, tileIdx);
+
+  LS_ERROR_CHECK(result);
+
+  *pResult = aR_done;
+
+epilogue:
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// Actors that pick their next nutrient at the end of `update_lifesupportActors`, as `chunk index * ActorChunkCapacity + slot` in `game::actorChunks`.
+static list<size_t> _NutrientSeekers;
+static list<size_t> _NutrientSeekerTiles;
+static list<uint32_t> _NutrientSeekerDistances;
+
+static const uint8_t EatingThreshold = 3;
+static const uint8_t AppetiteThreshold = 10;
+static const uint8_t MaxNutritionValue = 255;
+static const int64_t FoodItemGain = 16;
+static const uint8_t MaxFoodItemCount = 255;
+static const uint8_t MinFoodItemCount = 0;
+
+static const uint8_t ColdThreshold = 10;
+static const int64_t TemperatureIncrease = 255;
+static const uint8_t MaxTemperature = 255;
+
+static const size_t nutritionTypeCount = (_ptT_nutrient_last + 1) - _ptT_nutrient_first;
+static const size_t foodTypeCount = (_tile_type_food_last + 1) - _tile_type_food_first;
+static const int64_t FoodToNutrition[foodTypeCount][nutritionTypeCount] = { { 50, 0, 0, 0 } /*tomato*/, {0, 50, 0, 0} /*bean*/, { 0, 0, 50, 0 } /*wheat*/,  { 0, 0, 0, 50 } /*sunflower*/, {25, 25, 25, 25} /*meal*/ }; // foodtypes and nutrition value need to be in the same order as the corresponding enums!
+
+static const pathfinding_target_type Nutrients[nutritionTypeCount] = { ptT_vitamin, ptT_protein, ptT_carbohydrates, ptT_fat };
+
+// Results of `update_lifesupportActors` for one of `game::actorChunks`. Filled by the tick workers and read back in chunk order.
+struct lifesupport_chunk
+{
+  list<size_t> deferred; // Slots of the actors that have to read or change shared state, updated on the game thread in actor order.
+  list<size_t> nutrientSeekers; // See `_NutrientSeekers`.
+  list<size_t> nutrientSeekerTiles;
+};
+
+static list<lifesupport_chunk> _LifesupportChunks;
+
+// Only touches the actor itself, so this can run for any actor at any point of the tick.
+void lifesupportActor_seekSurvival(lifesupport_actor *pLifeSupport, movement_actor *pActor, const size_t actorIndex, const size_t tileIdx, lifesupport_chunk &chunk)
+{
+  if (_Game.levelInfo.isNight)
+  {
+    if (pLifeSupport->type != aT_fire_actor && pLifeSupport->temperature < ColdThreshold)
+    {
+      pActor->survivalActorActive = true;
+      pActor->target = ptT_fire;
+      pActor->atDestination = false;
+    }
+  }
+  else
+  {
+    bool anyNeededNutrion = false;
+
+    for (size_t j = 0; j < nutritionTypeCount; j++)
+    {
+      if (pLifeSupport->nutritions[j] < EatingThreshold)
+      {
+        anyNeededNutrion = true;
+        break;
+      }
+    }
+
+    if (anyNeededNutrion)
+    {
+      int8_t bestScore = 0;
+      size_t bestIndex = 0;
+
+      for (size_t i = 0; i < LS_ARRAYSIZE(pLifeSupport->lunchbox); i++)
+      {
+        if (pLifeSupport->lunchbox[i])
+        {
+          int8_t score = 0;
+
+          for (size_t j = 0; j < nutritionTypeCount; j++)
+            if (FoodToNutrition[i][j] > 0)
+              score += pLifeSupport->nutritions[j] < AppetiteThreshold ? nutritionTypeCount : -1;
+
+          if (score > bestScore)
+          {
+            bestScore = score;
+            bestIndex = i;
+          }
+        }
+      }
+
+      // eat best item
+      if (bestScore > 0)
+      {
+        for (size_t j = 0; j < nutritionTypeCount; j++)
+          modify_with_clamp(pLifeSupport->nutritions[j], FoodToNutrition[bestIndex][j], MinFoodItemCount, MaxFoodItemCount);
+
+        // remove from lunchbox
+        modify_with_clamp(pLifeSupport->lunchbox[bestIndex], (int64_t)-1, MinFoodItemCount, MaxFoodItemCount);
+
+        lsAssert(!pActor->isWaiting); // we need to eat after waiting else we just are hungry again. or dont eat when waiting?
+        pActor->isWaiting = true;
+        pActor->ticksToWait = 20;
+      }
+      else // if no item: set actor target, once all actors that need one are known.
+      {
+        if (LS_FAILED(list_add(&chunk.nutrientSeekerTiles, tileIdx)))
+          return; // Tries again next tick.
+
+        if (LS_FAILED(list_add(&chunk.nutrientSeekers, actorIndex)))
+          chunk.nutrientSeekerTiles.count--;
+      }
+    }
+  }
+}
+
+// Eats or warms up at the destination, changing the tile. Errors mean that the change couldn't be journaled, it has still happened.
+lsResult lifesupportActor_consume(lifesupport_actor *pLifeSupport, movement_actor *pActor, const size_t tileIdx)
+{
+  if (!pActor->atDestination)
+    return lsR_Success;
+
+  if (pActor->target >= _ptT_nutrient_first && pActor->target <= _ptT_nutrient_last)
+  {
+    // add food to lunchbox
+    if (_Game.levelInfo.pGameplayMap[tileIdx].tileType >= _tile_type_food_first && _Game.levelInfo.pGameplayMap[tileIdx].tileType <= _tile_type_food_last && _Game.levelInfo.pGameplayMap[tileIdx].resourceCount > 0) // check if this was ok? it sure didn't fix the issue that the farmer is stuck on empty food tiles...
+    {
+      const resource_type tileType = _Game.levelInfo.pGameplayMap[tileIdx].tileType;
+      lsAssert(tileType - _tile_type_food_first >= 0 && tileType - _tile_type_food_first <= _tile_type_food_last);
+      modify_with_clamp(pLifeSupport->lunchbox[tileType - _tile_type_food_first], FoodItemGain, MinFoodItemCount, MaxFoodItemCount);
+
+      const tile_snapshot previous = getTileSnapshot(tileIdx);
+      modify_with_clamp(_Game.levelInfo.pGameplayMap[tileIdx].resourceCount, -FoodItemGain);
+
+      //if (_Game.levelInfo.pGameplayMap[tileIdx].resourceCount == 0)
+      //  _Game.levelInfo.pGameplayMap[tileIdx] = gameplay_element(tT_grass, 1); // no `change_tile_to` usage because we check earlier
+
+      return journalTileChange(tileIdx, previous);
+    }
+    else
+    {
+      pActor->atDestination = false;
+    }
+  }
+  else if (pActor->target == ptT_fire)
+  {
+    // warm up at fire
+    if (_Game.levelInfo.pGameplayMap[tileIdx].tileType == tT_fire)
+    {
+      lsAssert(!pActor->isWaiting);
+
+      if (!pActor->atDestinationLastTick)
+      {
+        pActor->isWaiting = true;
+        pActor->ticksToWait = 50;
+        return lsR_Success;
+      }
+
+      if (_Game.levelInfo.pGameplayMap[tileIdx].resourceCount > 0)
+        modify_with_clamp(pLifeSupport->temperature, (int16_t)(200), (uint8_t)(0), MaxTemperature);
+
+      // for testing: remove from fire & remove fire when empty
+      lsAssert(_Game.levelInfo.pGameplayMap[tileIdx].resourceCount > 0);
+      const tile_snapshot previous = getTileSnapshot(tileIdx);
+      _Game.levelInfo.pGameplayMap[tileIdx].resourceCount--;
+
+      if (_Game.levelInfo.pGameplayMap[tileIdx].resourceCount == 0)
+        _Game.levelInfo.pGameplayMap[tileIdx].tileType = tT_fire_pit; // No usage of `change_tile_to` because of check above. Actually okay to just change the tileType as we want to keep `count` and the maximum counts of `tT_fire` and `tT_fire_pit` are the same.
+
+      return journalTileChange(tileIdx, previous);
+    }
+    else
+    {
+      pActor->atDestination = false;
+    }
+  }
+
+  return lsR_Success;
+}
+
+// Runs everything of a chunk that doesn't depend on other actors. Actors heading for survival targets are deferred, as reachability and their tiles may change through earlier actors.
+void lifesupportActors_updateChunk(const size_t chunkIndex)
+{
+  lifesupport_chunk &chunk = _LifesupportChunks[chunkIndex];
+  actor_chunk *pActors = _Game.actorChunks[chunkIndex];
+
+  list_clear(&chunk.deferred);
+  list_clear(&chunk.nutrientSeekers);
+  list_clear(&chunk.nutrientSeekerTiles);
+
+  for (size_t slot = 0; slot < pActors->count; slot++)
+  {
+    lifesupport_actor *pLifeSupport = &pActors->lifesupport[slot];
+    movement_actor *pActor = &pActors->movement[slot];
+
+    if (pActor->isWaiting) // We won't loose any nutrients or 
+      continue;
+
+    // TODO think about actual system to nutrition and temperature usage
+    // just for testing!!!!
+    if (_Game.levelInfo.isNight)
+    {
+      modify_with_clamp(pLifeSupport->temperature, (int16_t)(-1));
+    }
+    else
+    {
+      for (size_t j = 0; j < nutritionTypeCount; j++)
+        modify_with_clamp(pLifeSupport->nutritions[j], (int16_t)-1, (uint8_t)0, MaxNutritionValue);
+    }
+
+    if (pActor->survivalActorActive)
+    {
+      if (LS_FAILED(list_add(&chunk.deferred, slot))) // Reserved for the whole chunk.
+        lsFail(); // The actor would only be updated again next tick.
+
+      continue;
+    }
+
+    lifesupportActor_seekSurvival(pLifeSupport, pActor, chunkIndex * ActorChunkCapacity + slot, movementActor_tileIndex(pActors->entityIndex[slot]), chunk);
+  }
+}
+
+void update_lifesupportActors()
+{
+  list_clear(&_NutrientSeekers);
+  list_clear(&_NutrientSeekerTiles);
+
+  const size_t chunkCount = _Game.actorChunks.count;
+
+  while (_LifesupportChunks.count < chunkCount)
+  {
+    lifesupport_chunk chunk;
+
+    if (LS_FAILED(list_reserve(&chunk.deferred, ActorChunkCapacity)) || LS_FAILED(list_add(&_LifesupportChunks, std::move(chunk))))
+      return; // Tries again next tick.
+  }
+
+  parallel_for(chunkCount, 1, [](const size_t begin, const size_t end)
+    {
+      for (size_t i = begin; i < end; i++)
+        lifesupportActors_updateChunk(i);
+    });
+
+  // Apply the deferred actors in chunk order, exactly as if every actor had been updated one after another.
+  for (size_t i = 0; i < chunkCount; i++)
+  {
+    lifesupport_chunk &chunk = _LifesupportChunks[i];
+    actor_chunk *pActors = _Game.actorChunks[i];
+
+    for (const size_t slot : chunk.deferred)
+    {
+      lifesupport_actor *pLifeSupport = &pActors->lifesupport[slot];
+      movement_actor *pActor = &pActors->movement[slot];
+      const size_t tileIdx = movementActor_tileIndex(pActors->entityIndex[slot]);
+
+      if (!game_canReachTarget(pActor->target, tileIdx)) // Resetting the target in case the food is currently unreachable (actors will still be stuck if there is no food at all, but won't be stuck if there is *some* food, just not the one their target is set to.
+        lifesupportActor_seekSurvival(pLifeSupport, pActor, i * ActorChunkCapacity + slot, tileIdx, chunk);
+      else if (LS_FAILED(lifesupportActor_consume(pLifeSupport, pActor, tileIdx)))
+        return; // Tries again next tick, `journalTileChange` has already made the affected targets start over.
+    }
+
+    // Nutrient seekers only change themselves, so their order doesn't matter.
+    if (LS_FAILED(list_add_range(&_NutrientSeekers, chunk.nutrientSeekers.pValues, chunk.nutrientSeekers.count)) || LS_FAILED(list_add_range(&_NutrientSeekerTiles, chunk.nutrientSeekerTiles.pValues, chunk.nutrientSeekerTiles.count)))
+    {
+      _NutrientSeekerTiles.count = _NutrientSeekers.count = lsMin(_NutrientSeekers.count, _NutrientSeekerTiles.count); // Tries again next tick.
+    }
+  }
+
+  // Score the nutrients of all actors that need a new target in one go.
+  if (_NutrientSeekers.count && LS_SUCCESS(list_resize(&_NutrientSeekerDistances, _NutrientSeekers.count * nutritionTypeCount, (uint32_t)0)))
+  {
+    game_getTargetDistances(Nutrients, nutritionTypeCount, _NutrientSeekerTiles.pValues, _NutrientSeekerTiles.count, _NutrientSeekerDistances.pValues);
+
+    const int64_t maxDist = (int64_t)(_Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+
+    for (size_t i = 0; i < _NutrientSeekers.count; i++)
+    {
+      actor_chunk *pActors = _Game.actorChunks[_NutrientSeekers[i] / ActorChunkCapacity];
+      const size_t slot = _NutrientSeekers[i] % ActorChunkCapacity;
+      lifesupport_actor *pLifeSupport = &pActors->lifesupport[slot];
+      movement_actor *pActor = &pActors->movement[slot];
+      const uint32_t *pDistances = _NutrientSeekerDistances.pValues + i * nutritionTypeCount;
+
+      size_t lowestNutrient = nutritionTypeCount;
+      int64_t bestTargetScore = -1;
+
+      for (size_t j = 0; j < nutritionTypeCount; j++)
+      {
+        const uint8_t value = pLifeSupport->nutritions[j];
+        int64_t score = value < EatingThreshold ? lsMaxValue<int16_t>() : MaxNutritionValue - value;
+
+        if (pDistances[j] != UnreachableTargetDistance && value < EatingThreshold) // Not available yet is scored like unreachable.
+          score += maxDist - (int64_t)pDistances[j];
+
+        if (score > bestTargetScore)
+        {
+          bestTargetScore = score;
+          lowestNutrient = j;
+        }
+      }
+
+      lsAssert(bestTargetScore > -1 && lowestNutrient < nutritionTypeCount);
+
+      if ((pLifeSupport->type == aT_farmer || pLifeSupport->type == aT_cook) && pDistances[lowestNutrient] == UnreachableTargetDistance)
+        continue;
+
+      pActor->survivalActorActive = true;
+      pActor->target = Nutrients[lowestNutrient];
+      pActor->atDestination = false;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+bool resetAfterSurvival(movement_actor *pActor)
+{
+  lsAssert(!pActor->isWaiting); // Should be handled by the actors already
+
+  if (pActor->atDestination || (!_Game.levelInfo.isNight && pActor->target == ptT_fire))
+  {
+    pActor->survivalActorActive = false;
+    pActor->atDestination = false;
+
+    return true;
+  }
+
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// TODO: we could add ranges to operate in for the actors so they won't cross eachother's paths so much - well this does not quite work 1) because we can only ever have a range from where we currently are. 2) because actors need to go to fire/food further away. - only if the actors alwyas return to the one same place after everu step (but then every actor would need his own resource type...
+
+// TODO: houses: add houses that conclude to several pathfindingtypes at once (e.g. a kitchen where all food drop offs and nutrient types are...). in a further step: render houses that can be bigger than just one tile.
+
+// TODO: I really want to let things grow slowly, or have actors wait for x amount of time until a task is finished.
+// we could have a state var for tiles (uint8) which e.g. indicates the grow state, the plant is only recognized for pathfinding, when there the state is the matchting number - else it is just `unfillable`...
+// i'm not quite sure how this one number is best representing different things, enums? e.g. a specific plant state could mean 'unwatered' but there could also be something like: 0-7 means different grow states, allthough for the game logic (not rendering) the specific grow state is probably irrelevant, its just that it didn't grow enough yet, but if we don't save a specific number, we would need to have one that represents the same elsewhere to know when it's ready to enter the fully grown state.
+
+// omg i don't know if i like that but i just had the idea (again? may be coc's idea) that an actor when not enough food, won't move anymore, but there could be helpers that provide first aid aka food (nvm they can't pathfind towards an actor (only if the actor turns the tile he stands on into something different?)
+
+// I'm thinking I may want to simplify the actors and have every actor just do one or two tasks. like the lumberjack just planting trees and maybe watering them, whilst there is a woodworker which cuts and chops the wood. so the game is more about the right amount of actors? maybe I could simplify actors in general and make it much nicer to programm, as they just get generic interfaces.
+
+// Actors at their destination, grouped by the `action::type_t` they're about to execute, as `chunk index * ActorChunkCapacity + slot` in `game::actionChunks`.
+static list<size_t> _ActionBuckets[action::t_count];
+
+void update_actionActors()
+{
+  for (size_t i = 0; i < LS_ARRAYSIZE(_ActionBuckets); i++)
+    list_clear(&_ActionBuckets[i]);
+
+  for (size_t chunkIndex = 0; chunkIndex < _Game.actionChunks.count; chunkIndex++)
+  {
+    role_chunk<actor> *pChunk = _Game.actionChunks[chunkIndex];
+
+    for (size_t slot = 0; slot < pChunk->count; slot++)
+    {
+      actor *pActionActor = &pChunk->role[slot];
+      movement_actor *pActor = &pChunk->movement[slot];
+
+      if (pActor->isWaiting)
+        continue;
+
+      const size_t tileIdx = movementActor_tileIndex(pChunk->entityIndex[slot]);
+
+      // Actors with a different sequence at night start over with the other one.
+      if (pActionActor->night != _Game.levelInfo.isNight)
+      {
+        const bool sequenceChanged = ActionSequences[pActionActor->type][0].pActions != ActionSequences[pActionActor->type][1].pActions;
+        pActionActor->night = _Game.levelInfo.isNight;
+
+        if (sequenceChanged)
+        {
+          pActionActor->currentAction = 0;
+
+          if (!pActor->survivalActorActive)
+            pActor->atDestination = false;
+        }
+      }
+
+      // Handle Survival
+      if (pActor->survivalActorActive)
+      {
+        if (actor_sequence(pActionActor).interruptsSurvival)
+        {
+          pActor->survivalActorActive = false;
+          pActor->atDestination = false;
+        }
+        else if (!resetAfterSurvival(pActor))
+        {
+          continue;
+        }
+
+        actor_beginAction(pActionActor, pActor, pActionActor->currentAction, tileIdx);
+        continue;
+      }
+
+      if (pActor->atDestination)
+      {
+        if (LS_FAILED(list_add(&_ActionBuckets[actor_sequence(pActionActor).pActions[pActionActor->currentAction].type], chunkIndex * ActorChunkCapacity + slot)))
+          continue; // Tries again next tick.
+      }
+      else
+      {
+        actor_beginAction(pActionActor, pActor, pActionActor->currentAction, tileIdx); // The target of some actions changes on the way (e.g. cooks picking another meal).
+      }
+    }
+  }
+
+  for (size_t type = action::t_invalid + 1; type < action::t_count; type++)
+  {
+    for (const size_t actorIndex : _ActionBuckets[type])
+    {
+      role_chunk<actor> *pChunk = _Game.actionChunks[actorIndex / ActorChunkCapacity];
+      const size_t slot = actorIndex % ActorChunkCapacity;
+      actor *pActionActor = &pChunk->role[slot];
+      movement_actor *pActor = &pChunk->movement[slot];
+      const action_sequence &sequence = actor_sequence(pActionActor);
+      const action &actn = sequence.pActions[pActionActor->currentAction];
+
+      if (actn.waitTicks && !pActor->atDestinationLastTick)
+      {
+        pActor->isWaiting = true;
+        pActor->ticksToWait = actn.waitTicks;
+
+        continue;
+      }
+
+      const size_t tileIdx = movementActor_tileIndex(pChunk->entityIndex[slot]);
+      uint8_t next = pActionActor->currentAction;
+
+#ifdef _DEBUG
+      pathfinding_info targetInfo;
+      lsAssert(!pathfinding_peekInfo(pActor->target, tileIdx, &targetInfo) || targetInfo.dir == d_atDestination);
+#endif
+
+      action_result actionResult;
+      const lsResult executed = execute_action(actn, pActionActor, tileIdx, &actionResult);
+
+      switch (actionResult)
+      {
+      case aR_done: next = actn.next == action::Following ? (uint8_t)((next + 1) % sequence.count) : actn.next; break;
+      case aR_missing_item: next = actn.onMissingItem == action::Same ? next : actn.onMissingItem; break;
+      default: break;
+      }
+
+      actor_beginAction(pActionActor, pActor, next, tileIdx);
+      pActor->atDestination = false;
+
+      if (LS_FAILED(executed))
+        return; // Tries again next tick, the action itself has happened and `journalTileChange` has already made the affected targets start over.
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// TODO: handle nutrition loss? maybe ok in survival actor, but maybe some more thoughtthrough way
+
+static size_t ticksSincelastDayNightSwitch = 0;
+
+void handle_dayNightCycle()
+{
+  constexpr size_t DayLength = 500;
+  constexpr size_t NightLength = 300;
+
+  if (ticksSincelastDayNightSwitch == DayLength && !_Game.levelInfo.isNight)
+  {
+    _Game.levelInfo.isNight = true;
+    ticksSincelastDayNightSwitch = 0;
+  }
+  else if (ticksSincelastDayNightSwitch == NightLength && _Game.levelInfo.isNight)
+  {
+    _Game.levelInfo.isNight = false;
+    ticksSincelastDayNightSwitch = 0;
+  }
+
+  ticksSincelastDayNightSwitch++;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void game_update()
+{
+  void (*const Systems[])() = { handle_dayNightCycle, updateFloodfill, movementActor_move, update_lifesupportActors, update_actionActors };
+  static_assert(LS_ARRAYSIZE(Systems) == gS_count);
+
+  int64_t before = lsGetCurrentTimeNs();
+
+  for (size_t i = 0; i < LS_ARRAYSIZE(Systems); i++)
+  {
+    Systems[i]();
+
+    const int64_t after = lsGetCurrentTimeNs();
+    _Game.systemTimeNs[i] += (uint64_t)(after - before);
+    before = after;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void print_resouceType(const resource_type type)
+{
+  const char *types[] = { "tT_grass", "tT_soil", "tT_water", "tT_sand", "tT_sapling", "tT_tree", "tT_trunk", "tT_wood", "tT_fire", "tT_fire_pit", "tT_market",
+  "tT_tomato_plant", "tT_bean_plant", "tT_wheat_plant", "tT_sunflower_plant", "tT_tomato", "tT_bean", "tT_wheat", "tT_sunflower", "tT_meal", "tT_mountain" };
+
+  lsAssert(LS_ARRAYSIZE(types) == tT_count);
+  print(types[type], '\n');
+}
+
+lsResult player_switchTiles(const resource_type terrainType)
+{
+  lsResult result = lsR_Success;
+
+  lsAssert(_Game.levelInfo.playerPos.x >= 1 && _Game.levelInfo.playerPos.x <= _Game.levelInfo.map_size.x - 2 && _Game.levelInfo.playerPos.y >= 0 && _Game.levelInfo.playerPos.y <= _Game.levelInfo.map_size.y - 2);
+
+  const size_t idx = worldPosToTileIndex((vec2f)(_Game.levelInfo.playerPos));
+
+  lsAssert(idx < _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y);
+  lsAssert(terrainType < tT_count);
+
+  LS_ERROR_CHECK(setGameplayTile(idx, terrainType, MaxResourceCounts[terrainType]));
+
+#ifdef _DEBUG
+  print("Changed tile (", _Game.levelInfo.playerPos.x, ", ", _Game.levelInfo.playerPos.y, ") to: ");
+  print_resouceType(terrainType);
+#endif
+
+epilogue:
+  return result;
+}
+
+void player_move(const direction dir)
+{
+  lsAssert(dir > d_unreachable && dir < d_atDestination);
+  lsAssert(_Game.levelInfo.playerPos.x >= 1 && _Game.levelInfo.playerPos.x <= _Game.levelInfo.map_size.x - 2 && _Game.levelInfo.playerPos.y >= 0 && _Game.levelInfo.playerPos.y <= _Game.levelInfo.map_size.y - 2);
+
+  static const vec2i16 EvenDir[] = { vec2i16(0, -1), vec2i16(1, 0), vec2i16(0, 1), vec2i16(-1, 1), vec2i16(-1, 0), vec2i16(-1, -1) };
+  static const vec2i16 OddDir[] = { vec2i16(1, -1), vec2i16(1, 0), vec2i16(1, 1), vec2i16(0, 1), vec2i16(-1, 0), vec2i16(0, -1) };
+
+  const vec2i16 newPos = _Game.levelInfo.playerPos.y % 2 ? _Game.levelInfo.playerPos + OddDir[dir - 1] : _Game.levelInfo.playerPos + EvenDir[dir - 1];
+
+  if (newPos.x >= 1 && newPos.x <= _Game.levelInfo.map_size.x - 2 && newPos.y >= 1 && newPos.y <= _Game.levelInfo.map_size.y - 2)
+    _Game.levelInfo.playerPos = newPos;
+}
+
+enum player_command_type
+{
+  pCT_move,
+  pCT_switchTiles,
+};
+
+struct player_command
+{
+  player_command_type type;
+  direction dir;
+  resource_type terrainType;
+};
+
+// Player input can come from the render thread, so it's only applied by the tick.
+static struct
+{
+  std::mutex mutex;
+  list<player_command> pending;
+} _PlayerCommands;
+
+lsResult game_setPlayerMapIndex(const direction dir)
+{
+  lsResult result = lsR_Success;
+
+  player_command command;
+  command.type = pCT_move;
+  command.dir = dir;
+
+  {
+    std::lock_guard<std::mutex> lock(_PlayerCommands.mutex);
+    LS_ERROR_CHECK(list_add(&_PlayerCommands.pending, &command));
+  }
+
+epilogue:
+  return result;
+}
+
+lsResult game_playerSwitchTiles(const resource_type terrainType)
+{
+  lsResult result = lsR_Success;
+
+  player_command command;
+  command.type = pCT_switchTiles;
+  command.terrainType = terrainType;
+
+  {
+    std::lock_guard<std::mutex> lock(_PlayerCommands.mutex);
+    LS_ERROR_CHECK(list_add(&_PlayerCommands.pending, &command));
+  }
+
+epilogue:
+  return result;
+}
+
+// Applies every pending command, even if an earlier one failed. Returns the first error.
+lsResult applyPlayerCommands()
+{
+  lsResult result = lsR_Success;
+
+  std::lock_guard<std::mutex> lock(_PlayerCommands.mutex);
+
+  for (const player_command &command : _PlayerCommands.pending)
+  {
+    lsResult commandResult = lsR_Success;
+
+    switch (command.type)
+    {
+    case pCT_move: player_move(command.dir); break;
+    case pCT_switchTiles: commandResult = player_switchTiles(command.terrainType); break;
+    default: lsFail(); // not implemented.
+    }
+
+    if (LS_FAILED(commandResult) && LS_SUCCESS(result))
+      result = commandResult;
+  }
+
+  list_clear(&_PlayerCommands.pending);
+
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+lsResult game_init(const vec2s mapSize)
+{
+  level_settings settings;
+  settings.mapSize = mapSize;
+
+  return game_init_local(settings);
+}
+
+lsResult game_init(const level_settings &settings)
+{
+  return game_init_local(settings);
+}
+
+lsResult game_tick()
+{
+  return game_tick_local();
+}
+
+lsResult game_advance(const int64_t nowNs, _Out_ float_t *pInterpolation)
+{
+  lsResult result = lsR_Success;
+
+  constexpr size_t MaxTicksPerAdvance = 8; // After a stall we catch up over multiple calls instead of freezing the caller until we're back in time.
+  constexpr size_t MaxBacklogTicks = MaxTicksPerAdvance; // Ticks that are due for longer are dropped, so long stalls (or ticks slower than `tickRate`) don't keep us catching up forever.
+
+  const uint64_t tickDurationNs = 1000000000ULL / _Game.tickRate;
+  size_t ticks = 0;
+
+  if ((int64_t)_Game.nextTickTimeNs < nowNs - (int64_t)(MaxBacklogTicks * tickDurationNs))
+    _Game.nextTickTimeNs = (uint64_t)(nowNs - (int64_t)(MaxBacklogTicks * tickDurationNs));
+
+  while (_Game.nextTickTimeNs <= (uint64_t)nowNs && ticks < MaxTicksPerAdvance)
+  {
+    LS_ERROR_CHECK(game_tick());
+    _Game.nextTickTimeNs += tickDurationNs;
+    ticks++;
+  }
+
+  _Game.lastPredictTimeNs = (uint64_t)nowNs;
+
+  // The last tick happened at `nextTickTimeNs - tickDurationNs`.
+  *pInterpolation = lsClamp(1.f - (float_t)((int64_t)_Game.nextTickTimeNs - nowNs) / (float_t)tickDurationNs, 0.f, 1.f);
+
+epilogue:
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+constexpr uint8_t NewSnapshotBit = 0x80;
+
+// The simulation fills `snapshots[writeIndex]` and swaps it with the one in `ready`, the renderer swaps `readIndex` with it once it's new. Neither side ever waits for the other.
+static struct simulation_thread
+{
+  std::thread thread;
+  std::atomic<bool> running = false;
+  std::atomic<lsResult> result = lsR_Success;
+
+  game_snapshot snapshots[3];
+  uint8_t writeIndex = 0;
+  uint8_t readIndex = 1;
+  std::atomic<uint8_t> ready = 2;
+  bool hasAcquired = false;
+} _SimulationThread;
+
+lsResult snapshot_capture(game_snapshot &snapshot)
+{
+  lsResult result = lsR_Success;
+
+  const size_t tileCount = _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y;
+
+  if (snapshot.tileCapacity < tileCount)
+  {
+    LS_ERROR_CHECK(lsRealloc(&snapshot.pTileTypes, tileCount));
+    LS_ERROR_CHECK(lsRealloc(&snapshot.pElevations, tileCount));
+    snapshot.tileCapacity = tileCount;
+  }
+
+  snapshot.map_size = _Game.levelInfo.map_size;
+
+  for (size_t i = 0; i < tileCount; i++)
+  {
+    snapshot.pTileTypes[i] = _Game.levelInfo.pGameplayMap[i].tileType;
+    snapshot.pElevations[i] = _Game.levelInfo.pPathfindingMap[i].elevationLevel;
+  }
+
+  list_clear(&snapshot.actors);
+
+  for (size_t i = 0; i < _Game.movementKinematics.count; i++)
+  {
+    snapshot_actor actor;
+    actor.pos = movementActor_pos(i);
+    actor.previousPos = vec2f(_Game.movementKinematics.pPreviousPosX[i], _Game.movementKinematics.pPreviousPosY[i]);
+    actor.index = i;
+
+    LS_ERROR_CHECK(list_add(&snapshot.actors, &actor));
+  }
+
+  snapshot.debugTarget = _Game.actorChunks.count ? _Game.actorChunks[0]->movement[0].target : ptT_Count; // The first chunk starts with the first spawned actor.
+  snapshot.hasDebugDirections = false;
+
+  if (snapshot.debugTarget < ptT_Count - 1 && _Game.levelInfo.resources[snapshot.debugTarget].hasReadMap) // Not resident or still filling.
+  {
+    const level_info::resource_info &info = _Game.levelInfo.resources[snapshot.debugTarget];
+    const direction_map &readMap = info.directionMaps[1 - info.write_direction_idx];
+    const size_t byteCount = direction_map_byteCount(readMap.storage.count);
+
+    if (snapshot.debugDirectionCapacity < byteCount)
+    {
+      LS_ERROR_CHECK(lsRealloc(&snapshot.debugDirections.pDirections, byteCount));
+      snapshot.debugDirectionCapacity = byteCount;
+    }
+
+    lsMemcpy(snapshot.debugDirections.pDirections, readMap.pDirections, byteCount);
+    snapshot.debugDirections.storage = readMap.storage;
+    snapshot.hasDebugDirections = true;
+  }
+
+  snapshot.playerPos = _Game.levelInfo.playerPos;
+  snapshot.isNight = _Game.levelInfo.isNight;
+  snapshot.tickRate = _Game.tickRate;
+  snapshot.tickTimeNs = _Game.nextTickTimeNs - 1000000000ULL / _Game.tickRate;
+  snapshot.gameStartTimeNs = _Game.gameStartTimeNs;
+
+epilogue:
+  return result;
+}
+
+void snapshot_destroy(game_snapshot &snapshot)
+{
+  lsFreePtr(&snapshot.pTileTypes);
+  lsFreePtr(&snapshot.pElevations);
+  lsFreePtr(&snapshot.debugDirections.pDirections);
+  list_destroy(&snapshot.actors);
+
+  snapshot.tileCapacity = 0;
+  snapshot.debugDirectionCapacity = 0;
+}
+
+void simulationThread_func()
+{
+  while (_SimulationThread.running)
+  {
+    const uint64_t nextTickTimeNs = _Game.nextTickTimeNs;
+
+    float_t interpolation;
+    const lsResult result = game_advance(lsGetCurrentTimeNs(), &interpolation);
+
+    if (LS_FAILED(result))
+    {
+      _SimulationThread.result = result;
+      return;
+    }
+
+    if (_Game.nextTickTimeNs != nextTickTimeNs && LS_SUCCESS(snapshot_capture(_SimulationThread.snapshots[_SimulationThread.writeIndex]))) // Otherwise the renderer keeps the last snapshot.
+      _SimulationThread.writeIndex = (uint8_t)(_SimulationThread.ready.exchange((uint8_t)(_SimulationThread.writeIndex | NewSnapshotBit)) & ~NewSnapshotBit);
+
+    const int64_t remainingNs = (int64_t)_Game.nextTickTimeNs - lsGetCurrentTimeNs();
+
+    if (remainingNs > 0)
+      std::this_thread::sleep_for(std::chrono::nanoseconds(remainingNs));
+  }
+}
+
+lsResult game_startSimulationThread()
+{
+  lsResult result = lsR_Success;
+
+  LS_ERROR_IF(_SimulationThread.running, lsR_ResourceStateInvalid);
+
+  _SimulationThread.result = lsR_Success;
+  _SimulationThread.running = true;
+  _SimulationThread.thread = std::thread(simulationThread_func);
+
+epilogue:
+  return result;
+}
+
+void game_stopSimulationThread()
+{
+  if (!_SimulationThread.running)
+    return;
+
+  _SimulationThread.running = false;
+  _SimulationThread.thread.join();
+
+  for (size_t i = 0; i < LS_ARRAYSIZE(_SimulationThread.snapshots); i++)
+    snapshot_destroy(_SimulationThread.snapshots[i]);
+
+  _SimulationThread.writeIndex = 0;
+  _SimulationThread.readIndex = 1;
+  _SimulationThread.ready = 2;
+  _SimulationThread.hasAcquired = false;
+}
+
+lsResult game_acquireSnapshot(_Out_ const game_snapshot **ppSnapshot)
+{
+  lsResult result = lsR_Success;
+
+  LS_ERROR_IF(ppSnapshot == nullptr, lsR_ArgumentNull);
+  LS_ERROR_CHECK(_SimulationThread.result.load());
+
+  if (_SimulationThread.ready.load() & NewSnapshotBit)
+  {
+    _SimulationThread.readIndex = (uint8_t)(_SimulationThread.ready.exchange(_SimulationThread.readIndex) & ~NewSnapshotBit);
+    _SimulationThread.hasAcquired = true;
+  }
+
+  *ppSnapshot = _SimulationThread.hasAcquired ? &_SimulationThread.snapshots[_SimulationThread.readIndex] : nullptr;
+
+epilogue:
+  return result;
+}
+
+float_t game_snapshotInterpolation(const game_snapshot &snapshot, const int64_t nowNs)
+{
+  return lsClamp((float_t)(nowNs - (int64_t)snapshot.tickTimeNs) / (1e9f / (float_t)snapshot.tickRate), 0.f, 1.f);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+game *game_getGame()
+{
+  return &_Game;
+}
+
+size_t game_getTickRate()
+{
+  return _Game.tickRate;
+}
+
+void game_setTickRate(const size_t ticksPerSecond)
+{
+  lsAssert(ticksPerSecond > 0);
+  _Game.tickRate = ticksPerSecond;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+lsResult game_init_local(const level_settings &settings)
+{
+  lsResult result = lsR_Success;
+
+  LS_ERROR_CHECK(initializeLevel(settings));
+
+  if (job_system_workerCount() == 0)
+    LS_ERROR_CHECK(job_system_init());
+
+  _Game.gameStartTimeNs = _Game.lastUpdateTimeNs = _Game.lastPredictTimeNs = _Game.nextTickTimeNs = lsGetCurrentTimeNs();
+
+  goto epilogue;
+epilogue:
+  return result;
 }
 
 lsResult game_tick_local()
@@ -1708,6 +4436,11 @@ lsResult game_tick_local()
   //const float_t simFactor = (float_t)(tick - lastTick) / (1e+9f / (float_t)_Game.tickRate);
   _Game.lastUpdateTimeNs = tick;
 
+  lsMemcpy(_Game.movementKinematics.pPreviousPosX, _Game.movementKinematics.pPosX, _Game.movementKinematics.count);
+  lsMemcpy(_Game.movementKinematics.pPreviousPosY, _Game.movementKinematics.pPosY, _Game.movementKinematics.count);
+
+  LS_ERROR_CHECK(applyPlayerCommands());
+
   // stuff.
   // process player interactions.
   {
@@ -1718,3 +4451,308 @@ lsResult game_tick_local()
     return result;
   }
 }
+
+//////////////////////////////////////////////////////////////////////////
+
+// Replaces the level with a `width` x `height` map of `tT_grass` surrounded by `tT_mountain`, without any resident targets.
+// Tiles can be written directly until `testLevel_finish` is called.
+static lsResult testLevel_init(const size_t width, const size_t height)
+{
+  lsResult result = lsR_Success;
+
+  for (size_t i = 0; i < ptT_Count - 1; i++) // Skip ptT_collidable
+  {
+    if (_Game.levelInfo.resources[i].directionMaps[0].pDirections != nullptr)
+      evict_resource_info(_Game.levelInfo.resources[i]);
+
+    _Game.levelInfo.resources[i].processedChangeCount = 0;
+  }
+
+  hierarchy_destroy();
+  _Game.levelInfo.pathfindingHierarchy.processedChangeCount = 0;
+  list_clear(&_Game.levelInfo.tileChanges);
+
+  // Everything that is sized by the map.
+  lsFreePtr(&_Game.levelInfo.pPathfindingMap);
+  lsFreePtr(&_Game.levelInfo.pGameplayMap);
+  lsFreePtr(&_Game.levelInfo.pTileComponents);
+  lsFreePtr(&_Game.levelInfo.pElevationMasks);
+  lsFreePtr(&_Game.levelInfo.pReachableMasks);
+  _Game.levelInfo.elevationMaskLevelCount = 0;
+  _Game.levelInfo.elevationMasksDirty = true;
+  _Game.levelInfo.tileComponentsDirty = true;
+  _Game.levelInfo.unjournaledTargets = 0;
+
+  LS_ERROR_CHECK(mapInit(width, height));
+
+  for (size_t i = 0; i < width * height; i++)
+    _Game.levelInfo.pGameplayMap[i] = gameplay_element(tT_grass, MaxResourceCounts[tT_grass]);
+
+  setMapBorder();
+
+epilogue:
+  return result;
+}
+
+static void testLevel_finish(const pathfinding_layout layout)
+{
+  updateAllPassableNeighbors();
+  _Game.levelInfo.pathfindingLayout = layout;
+  game_setPathfindingBudget(_Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y * (ptT_Count - 1)); // Every fill completes within one tick.
+}
+
+// Runs the pathfinding until the distance is available.
+static bool testLevel_getTargetDistance(const pathfinding_target_type target, const size_t tileIdx, _Out_ uint32_t *pDist, _Out_opt_ bool *pApproximate = nullptr)
+{
+  constexpr size_t MaxTicks = 16;
+
+  for (size_t tick = 0; tick < MaxTicks; tick++)
+  {
+    if (game_getTargetDistance(target, tileIdx, pDist, pApproximate))
+      return true;
+
+    updateFloodfill();
+  }
+
+  return false;
+}
+
+// Breadth first search over the tiles that aren't collidable, independent of the passable neighbours and direction maps.
+static lsResult testLevel_expectedDistances(const size_t targetTileIdx, list<uint32_t> *pDistances)
+{
+  lsResult result = lsR_Success;
+
+  queue<size_t> open;
+
+  LS_ERROR_CHECK(list_resize(pDistances, _Game.levelInfo.map_size.x * _Game.levelInfo.map_size.y, UnreachableTargetDistance));
+  (*pDistances)[targetTileIdx] = 0;
+  LS_ERROR_CHECK(queue_pushBack(&open, targetTileIdx));
+
+  while (open.count)
+  {
+    size_t current;
+    LS_ERROR_CHECK(queue_popFront(&open, &current));
+
+    for (uint8_t d = d_topRight; d <= d_topLeft; d++)
+    {
+      const size_t neighbor = tileNeighbor(current, (direction)d); // The border is collidable, so this never leaves the map.
+
+      if ((*pDistances)[neighbor] != UnreachableTargetDistance || (tile_target_mask(_Game.levelInfo.pGameplayMap[neighbor]) & CollidableTargetBit))
+        continue;
+
+      (*pDistances)[neighbor] = (*pDistances)[current] + 1;
+      LS_ERROR_CHECK(queue_pushBack(&open, neighbor));
+    }
+  }
+
+epilogue:
+  queue_destroy(&open);
+  return result;
+}
+
+DEFINE_TESTABLE(game_pathfinding_exactLongDistances)
+{
+  lsResult result = lsR_Success;
+
+  const bool initialized = job_system_workerCount() == 0 && LS_SUCCESS(job_system_init(3));
+  list<uint32_t> expected;
+
+  {
+    constexpr size_t Width = 400;
+    constexpr size_t Height = 400;
+    const size_t targetTileIdx = Width + 1;
+
+    TESTABLE_ASSERT_SUCCESS(testLevel_init(Width, Height));
+
+    // Every even row is a wall with a single gap, alternating between both ends, so the only path winds through all odd rows.
+    for (size_t y = 2; y < Height - 1; y += 2)
+      for (size_t x = 1; x < Width - 1; x++)
+        if (y + 2 >= Height || x != (((y / 2) & 1) ? Width - 2 : 1))
+          _Game.levelInfo.pGameplayMap[y * Width + x] = gameplay_element(tT_mountain, 0);
+
+    _Game.levelInfo.pGameplayMap[targetTileIdx] = gameplay_element(tT_tomato, MaxResourceCounts[tT_tomato]); // `ptT_vitamin`
+    testLevel_finish(pL_flat);
+
+    TESTABLE_ASSERT_SUCCESS(testLevel_expectedDistances(targetTileIdx, &expected));
+
+    uint32_t longest = 0;
+
+    for (size_t i = 0; i < Width * Height; i++)
+    {
+      if (expected[i] == UnreachableTargetDistance)
+        continue;
+
+      uint32_t dist;
+      TESTABLE_ASSERT_TRUE(testLevel_getTargetDistance(ptT_vitamin, i, &dist));
+      TESTABLE_ASSERT_EQUAL(dist, expected[i]);
+
+      longest = lsMax(longest, dist);
+    }
+
+    TESTABLE_ASSERT_TRUE(longest > lsMaxValue<uint16_t>());
+  }
+
+epilogue:
+  list_destroy(&expected);
+
+  if (initialized)
+    job_system_destroy();
+
+  return result;
+}
+
+DEFINE_TESTABLE(game_pathfinding_hierarchicalDistances)
+{
+  lsResult result = lsR_Success;
+
+  const bool initialized = job_system_workerCount() == 0 && LS_SUCCESS(job_system_init(3));
+  list<uint32_t> flatDistances;
+
+  {
+    constexpr size_t Width = 96;
+    constexpr size_t Height = 96;
+    const size_t targetTileIdx = 2 * Width + 2;
+
+    // Walls across the map with short gaps at different heights, so most paths have to wind through several clusters.
+    const auto buildLevel = [](const pathfinding_layout layout) -> lsResult
+    {
+      lsResult result = lsR_Success;
+
+      constexpr size_t WallX[] = { 24, 48, 72 };
+      constexpr size_t GapY[] = { 80, 10, 60 };
+      constexpr size_t GapHeight = 3;
+
+      LS_ERROR_CHECK(testLevel_init(Width, Height));
+
+      for (size_t i = 0; i < LS_ARRAYSIZE(WallX); i++)
+        for (size_t y = 1; y < Height - 1; y++)
+          if (y < GapY[i] || y >= GapY[i] + GapHeight)
+            _Game.levelInfo.pGameplayMap[y * Width + WallX[i]] = gameplay_element(tT_mountain, 0);
+
+      _Game.levelInfo.pGameplayMap[2 * Width + 2] = gameplay_element(tT_tomato, MaxResourceCounts[tT_tomato]); // `ptT_vitamin`
+      testLevel_finish(layout);
+
+    epilogue:
+      return result;
+    };
+
+    TESTABLE_ASSERT_SUCCESS(buildLevel(pL_flat));
+    TESTABLE_ASSERT_SUCCESS(list_resize(&flatDistances, Width * Height, UnreachableTargetDistance));
+
+    for (size_t i = 0; i < Width * Height; i++)
+    {
+      bool approximate = true;
+      TESTABLE_ASSERT_TRUE(testLevel_getTargetDistance(ptT_vitamin, i, &flatDistances[i], &approximate));
+      TESTABLE_ASSERT_FALSE(approximate);
+    }
+
+    TESTABLE_ASSERT_SUCCESS(buildLevel(pL_hierarchical));
+
+    size_t longerCount = 0;
+
+    for (size_t i = 0; i < Width * Height; i++)
+    {
+      uint32_t dist;
+      bool approximate = false;
+      TESTABLE_ASSERT_TRUE(testLevel_getTargetDistance(ptT_vitamin, i, &dist, &approximate));
+      TESTABLE_ASSERT_TRUE(approximate);
+
+      // Reachability is the same, distances can only get longer by leading through the entrances.
+      TESTABLE_ASSERT_EQUAL(dist == UnreachableTargetDistance, flatDistances[i] == UnreachableTargetDistance);
+      TESTABLE_ASSERT_TRUE(dist >= flatDistances[i]);
+
+      if (dist != flatDistances[i])
+        longerCount++;
+    }
+
+    TESTABLE_ASSERT_EQUAL(flatDistances[targetTileIdx], 0u);
+    TESTABLE_ASSERT_TRUE(longerCount > 0); // Otherwise the map doesn't tell the layouts apart.
+  }
+
+epilogue:
+  list_destroy(&flatDistances);
+
+  if (initialized)
+    job_system_destroy();
+
+  return result;
+}
+
+DEFINE_TESTABLE(game_pathfinding_hierarchyPartialRebuild)
+{
+  lsResult result = lsR_Success;
+
+  const bool initialized = job_system_workerCount() == 0 && LS_SUCCESS(job_system_init(3));
+  list<uint32_t> partialDistances;
+
+  {
+    constexpr size_t Width = 96;
+    constexpr size_t Height = 96;
+    constexpr size_t ChangedX = 40; // Inside of cluster (2, 2), not next to its border.
+    constexpr size_t ChangedY = 40;
+
+    const auto buildLevel = [](const bool withChange) -> lsResult
+    {
+      lsResult result = lsR_Success;
+
+      LS_ERROR_CHECK(testLevel_init(Width, Height));
+
+      if (withChange)
+        _Game.levelInfo.pGameplayMap[ChangedY * Width + ChangedX] = gameplay_element(tT_mountain, 0);
+
+      _Game.levelInfo.pGameplayMap[2 * Width + 2] = gameplay_element(tT_tomato, MaxResourceCounts[tT_tomato]); // `ptT_vitamin`
+      testLevel_finish(pL_hierarchical);
+
+    epilogue:
+      return result;
+    };
+
+    const pathfinding_hierarchy &h = _Game.levelInfo.pathfindingHierarchy;
+    const size_t clusterCountX = Width / PathfindingClusterSize;
+
+    TESTABLE_ASSERT_SUCCESS(buildLevel(false));
+
+    uint32_t dist;
+    TESTABLE_ASSERT_TRUE(testLevel_getTargetDistance(ptT_vitamin, 0, &dist));
+    TESTABLE_ASSERT_EQUAL(h.rebuiltClusters.count, clusterCountX * clusterCountX); // The first build covers everything.
+
+    const uint32_t graphVersion = h.graphVersion;
+    TESTABLE_ASSERT_SUCCESS(setGameplayTile(ChangedY * Width + ChangedX, tT_mountain, 0));
+    updateFloodfill();
+
+    TESTABLE_ASSERT_EQUAL(h.graphVersion, graphVersion + 1);
+    TESTABLE_ASSERT_FALSE(h.graphDirty);
+    TESTABLE_ASSERT_FALSE(h.clustersDirty);
+    TESTABLE_ASSERT_EQUAL(h.rebuiltClusters.count, (size_t)9); // The changed cluster and its neighbours.
+
+    for (const uint32_t cluster : h.rebuiltClusters)
+    {
+      TESTABLE_ASSERT_TRUE(lsAbs((int64_t)(cluster % clusterCountX) - (int64_t)(ChangedX / PathfindingClusterSize)) <= 1);
+      TESTABLE_ASSERT_TRUE(lsAbs((int64_t)(cluster / clusterCountX) - (int64_t)(ChangedY / PathfindingClusterSize)) <= 1);
+    }
+
+    TESTABLE_ASSERT_SUCCESS(list_resize(&partialDistances, Width * Height, UnreachableTargetDistance));
+
+    for (size_t i = 0; i < Width * Height; i++)
+      TESTABLE_ASSERT_TRUE(testLevel_getTargetDistance(ptT_vitamin, i, &partialDistances[i]));
+
+    TESTABLE_ASSERT_EQUAL(partialDistances[ChangedY * Width + ChangedX], UnreachableTargetDistance);
+
+    // The same map built from scratch has to come up with the same graph.
+    TESTABLE_ASSERT_SUCCESS(buildLevel(true));
+
+    for (size_t i = 0; i < Width * Height; i++)
+    {
+      TESTABLE_ASSERT_TRUE(testLevel_getTargetDistance(ptT_vitamin, i, &dist));
+      TESTABLE_ASSERT_EQUAL(dist, partialDistances[i]);
+    }
+  }
+
+epilogue:
+  list_destroy(&partialDistances);
+
+  if (initialized)
+    job_system_destroy();
+
+  return result;
+}
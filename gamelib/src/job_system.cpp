@@ -0,0 +1,604 @@
+#include "job_system.h"
+
+#include "queue.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "testable.h"
+REGISTER_TESTABLE_FILE(9)
+
+//////////////////////////////////////////////////////////////////////////
+
+constexpr size_t MaxJobWorkers = 32;
+constexpr size_t MaxJobContinuations = 4;
+constexpr size_t JobCapacity = 4096; // Jobs in flight at once, `job_create` blocks until a slot frees up beyond that.
+constexpr size_t JobDequeCapacity = 4096;
+constexpr size_t MaxParallelForBatches = 256; // Keeps `parallel_for` well within `JobCapacity`.
+constexpr size_t JobSpinCount = 64; // Attempts to find a job before a worker goes to sleep.
+
+static_assert((JobCapacity & (JobCapacity - 1)) == 0 && (JobDequeCapacity & (JobDequeCapacity - 1)) == 0);
+
+struct job
+{
+  job_func func;
+  void *pUserData;
+  size_t index;
+  job *pParent;
+  std::atomic<int32_t> unfinished; // This job and its unfinished children.
+  std::atomic<int32_t> dependencies; // Unfinished jobs this one is a continuation of.
+  std::atomic<int32_t> continuationCount;
+  job *pContinuations[MaxJobContinuations];
+};
+
+// Chase-Lev deque (with the memory orders of "Correct and Efficient Work-Stealing for Weak Memory Models", Lê et al. 2013), fixed capacity.
+struct job_deque
+{
+  std::atomic<int64_t> top = 0;
+  uint8_t _padding[64 - sizeof(std::atomic<int64_t>)]; // Thieves only touch `top`, keep it off the cache line of `bottom`.
+  std::atomic<int64_t> bottom = 0;
+  std::atomic<job *> jobs[JobDequeCapacity];
+};
+
+static struct job_system
+{
+  std::thread threads[MaxJobWorkers];
+  job_deque deques[MaxJobWorkers];
+  size_t workerCount = 0;
+
+  std::mutex mutex; // Protects `submitted`, `signal` and `shutdown`.
+  std::condition_variable wakeCondition;
+  queue<job *> submitted; // Jobs run by threads that aren't workers.
+  std::atomic<size_t> submittedCount = 0;
+  std::atomic<size_t> sleepingWorkers = 0;
+  uint64_t signal = 0;
+  bool shutdown = false;
+
+  job jobs[JobCapacity];
+  std::atomic<size_t> nextJob = 0;
+
+  ~job_system()
+  {
+    job_system_destroy();
+  }
+} _JobSystem;
+
+static thread_local size_t _JobWorkerIndex = (size_t)-1; // Only set on worker threads.
+
+//////////////////////////////////////////////////////////////////////////
+
+bool job_deque_push(job_deque &deque, job *pJob)
+{
+  const int64_t bottom = deque.bottom.load(std::memory_order_relaxed);
+  const int64_t top = deque.top.load(std::memory_order_acquire);
+
+  if (bottom - top >= (int64_t)JobDequeCapacity)
+    return false;
+
+  deque.jobs[bottom & (JobDequeCapacity - 1)].store(pJob, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  deque.bottom.store(bottom + 1, std::memory_order_relaxed);
+
+  return true;
+}
+
+job *job_deque_pop(job_deque &deque)
+{
+  const int64_t bottom = deque.bottom.load(std::memory_order_relaxed) - 1;
+  deque.bottom.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t top = deque.top.load(std::memory_order_relaxed);
+
+  if (top > bottom)
+  {
+    deque.bottom.store(bottom + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  job *pJob = deque.jobs[bottom & (JobDequeCapacity - 1)].load(std::memory_order_relaxed);
+
+  if (top == bottom) // Last job, race the thieves for it.
+  {
+    if (!deque.top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      pJob = nullptr;
+
+    deque.bottom.store(bottom + 1, std::memory_order_relaxed);
+  }
+
+  return pJob;
+}
+
+job *job_deque_steal(job_deque &deque)
+{
+  int64_t top = deque.top.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const int64_t bottom = deque.bottom.load(std::memory_order_acquire);
+
+  if (top >= bottom)
+    return nullptr;
+
+  job *pJob = deque.jobs[top & (JobDequeCapacity - 1)].load(std::memory_order_relaxed);
+
+  if (!deque.top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    return nullptr;
+
+  return pJob;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+bool job_system_hasWork()
+{
+  if (_JobSystem.submittedCount.load() > 0)
+    return true;
+
+  for (size_t i = 0; i < _JobSystem.workerCount; i++)
+    if (_JobSystem.deques[i].top.load() < _JobSystem.deques[i].bottom.load())
+      return true;
+
+  return false;
+}
+
+void job_system_wake()
+{
+  // The work was published with a relaxed store, without this fence the load below could be ordered before it, missing a worker that went to sleep after checking for work.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  if (_JobSystem.sleepingWorkers.load() == 0)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(_JobSystem.mutex);
+    _JobSystem.signal++;
+  }
+
+  _JobSystem.wakeCondition.notify_one();
+}
+
+job *job_system_next(const size_t workerIndex)
+{
+  job *pJob = nullptr;
+
+  if (workerIndex < _JobSystem.workerCount)
+    if ((pJob = job_deque_pop(_JobSystem.deques[workerIndex])) != nullptr)
+      return pJob;
+
+  if (_JobSystem.submittedCount.load() > 0)
+  {
+    std::lock_guard<std::mutex> lock(_JobSystem.mutex);
+
+    // Another thread may have taken the last one since we checked, don't report that as an error.
+    if (_JobSystem.submitted.count > 0 && LS_SUCCESS(queue_popFront(&_JobSystem.submitted, &pJob)))
+    {
+      _JobSystem.submittedCount--;
+      return pJob;
+    }
+  }
+
+  // Start stealing next to ourselves, so thieves don't all go for the same victim.
+  const size_t offset = workerIndex < _JobSystem.workerCount ? workerIndex + 1 : 0;
+
+  for (size_t i = 0; i < _JobSystem.workerCount; i++)
+  {
+    const size_t victim = (offset + i) % _JobSystem.workerCount;
+
+    if (victim != workerIndex && (pJob = job_deque_steal(_JobSystem.deques[victim])) != nullptr)
+      return pJob;
+  }
+
+  return nullptr;
+}
+
+void job_finish(job *pJob)
+{
+  // Everything but `unfinished` is immutable while the job runs, but may be recycled as soon as it finished.
+  job *pParent = pJob->pParent;
+  job *pContinuations[MaxJobContinuations];
+  const int32_t continuationCount = pJob->continuationCount.load();
+
+  for (int32_t i = 0; i < continuationCount; i++)
+    pContinuations[i] = pJob->pContinuations[i];
+
+  if (pJob->unfinished.fetch_sub(1) != 1)
+    return;
+
+  for (int32_t i = 0; i < continuationCount; i++)
+    if (pContinuations[i]->dependencies.fetch_sub(1) == 1)
+      job_run(pContinuations[i]);
+
+  if (pParent != nullptr)
+    job_finish(pParent);
+}
+
+void job_execute(job *pJob)
+{
+  pJob->func(pJob->pUserData, pJob->index);
+  job_finish(pJob);
+}
+
+void job_system_workerFunc(const size_t workerIndex)
+{
+  _JobWorkerIndex = workerIndex;
+
+  while (true)
+  {
+    job *pJob = nullptr;
+
+    for (size_t i = 0; i < JobSpinCount && pJob == nullptr; i++)
+    {
+      pJob = job_system_next(workerIndex);
+
+      if (pJob == nullptr)
+        std::this_thread::yield();
+    }
+
+    if (pJob != nullptr)
+    {
+      job_execute(pJob);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(_JobSystem.mutex);
+
+    if (_JobSystem.shutdown)
+      return;
+
+    // Has to be visible before checking for work again, so a thread running a job either sees us sleeping or we see its job.
+    _JobSystem.sleepingWorkers++;
+    const uint64_t signal = _JobSystem.signal;
+    _JobSystem.wakeCondition.wait(lock, [&]() { return _JobSystem.shutdown || _JobSystem.signal != signal || job_system_hasWork(); });
+    _JobSystem.sleepingWorkers--;
+
+    if (_JobSystem.shutdown)
+      return;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+lsResult job_system_init(const size_t workerCount /* = (size_t)-1 */)
+{
+  lsResult result = lsR_Success;
+
+  LS_ERROR_IF(_JobSystem.workerCount != 0, lsR_ResourceStateInvalid);
+
+  {
+    const size_t hardwareThreads = std::thread::hardware_concurrency();
+    const size_t count = lsMin(MaxJobWorkers, workerCount != (size_t)-1 ? workerCount : (hardwareThreads > 1 ? hardwareThreads - 1 : 0));
+
+    _JobSystem.shutdown = false;
+    _JobSystem.workerCount = count; // Has to be set before the first worker starts stealing.
+
+    for (size_t i = 0; i < count; i++)
+      _JobSystem.threads[i] = std::thread(job_system_workerFunc, i);
+  }
+
+epilogue:
+  return result;
+}
+
+void job_system_destroy()
+{
+  if (_JobSystem.workerCount == 0)
+    return;
+
+  {
+    std::lock_guard<std::mutex> lock(_JobSystem.mutex);
+    _JobSystem.shutdown = true;
+  }
+
+  _JobSystem.wakeCondition.notify_all();
+
+  for (size_t i = 0; i < _JobSystem.workerCount; i++)
+    _JobSystem.threads[i].join();
+
+  _JobSystem.workerCount = 0;
+  queue_destroy(&_JobSystem.submitted);
+}
+
+size_t job_system_workerCount()
+{
+  return _JobSystem.workerCount;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+job *job_create(const job_func func, void *pUserData /* = nullptr */, const size_t index /* = 0 */, job *pParent /* = nullptr */)
+{
+  lsAssert(func != nullptr);
+
+  job *pJob = nullptr;
+
+  // Slots are handed out round robin, skipping the ones still in flight (e.g. parents or continuations that didn't run yet). If all of them are, help out until one finishes.
+  while (true)
+  {
+    for (size_t i = 0; i < JobCapacity && pJob == nullptr; i++)
+    {
+      job *pCandidate = &_JobSystem.jobs[_JobSystem.nextJob.fetch_add(1) & (JobCapacity - 1)];
+      int32_t expected = 0;
+
+      if (pCandidate->unfinished.compare_exchange_strong(expected, 1))
+        pJob = pCandidate;
+    }
+
+    if (pJob != nullptr)
+      break;
+
+    job *pOther = job_system_next(_JobWorkerIndex);
+
+    if (pOther != nullptr)
+      job_execute(pOther);
+    else
+      std::this_thread::yield();
+  }
+
+  pJob->func = func;
+  pJob->pUserData = pUserData;
+  pJob->index = index;
+  pJob->pParent = pParent;
+  pJob->dependencies.store(0);
+  pJob->continuationCount.store(0);
+
+  if (pParent != nullptr)
+  {
+    lsAssert(!job_isFinished(pParent));
+    pParent->unfinished++;
+  }
+
+  return pJob;
+}
+
+lsResult job_addContinuation(job *pJob, job *pContinuation)
+{
+  lsResult result = lsR_Success;
+
+  LS_ERROR_IF(pJob == nullptr || pContinuation == nullptr, lsR_ArgumentNull);
+  LS_ERROR_IF(pJob->continuationCount.load() >= (int32_t)MaxJobContinuations, lsR_ResourceFull);
+
+  pContinuation->dependencies++;
+  pJob->pContinuations[pJob->continuationCount.load()] = pContinuation;
+  pJob->continuationCount++;
+
+epilogue:
+  return result;
+}
+
+void job_run(job *pJob)
+{
+  lsAssert(pJob != nullptr && pJob->dependencies.load() == 0);
+
+  if (_JobSystem.workerCount == 0)
+  {
+    job_execute(pJob);
+    return;
+  }
+
+  if (_JobWorkerIndex < _JobSystem.workerCount)
+  {
+    if (!job_deque_push(_JobSystem.deques[_JobWorkerIndex], pJob))
+    {
+      job_execute(pJob); // The deque is full, there's plenty of work left for the others.
+      return;
+    }
+  }
+  else
+  {
+    std::unique_lock<std::mutex> lock(_JobSystem.mutex);
+
+    if (LS_FAILED(queue_pushBack(&_JobSystem.submitted, pJob)))
+    {
+      lock.unlock();
+      job_execute(pJob);
+      return;
+    }
+
+    _JobSystem.submittedCount++;
+  }
+
+  job_system_wake();
+}
+
+void job_wait(const job *pJob)
+{
+  while (!job_isFinished(pJob))
+  {
+    job *pNext = job_system_next(_JobWorkerIndex);
+
+    if (pNext != nullptr)
+      job_execute(pNext);
+    else
+      std::this_thread::yield();
+  }
+}
+
+bool job_isFinished(const job *pJob)
+{
+  return pJob->unfinished.load() == 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+struct parallel_for_context
+{
+  void (*func)(void *pUserData, const size_t begin, const size_t end);
+  void *pUserData;
+  size_t count, batchSize, batchCount;
+  job *pRoot;
+};
+
+void parallel_for_batch(void *pUserData, const size_t batch)
+{
+  const parallel_for_context *pContext = reinterpret_cast<const parallel_for_context *>(pUserData);
+  const size_t begin = batch * pContext->batchSize;
+
+  pContext->func(pContext->pUserData, begin, lsMin(begin + pContext->batchSize, pContext->count));
+}
+
+// Runs on whichever worker picked up the root, so the batches start out in its deque and get stolen from there.
+void parallel_for_split(void *pUserData, const size_t)
+{
+  const parallel_for_context *pContext = reinterpret_cast<const parallel_for_context *>(pUserData);
+
+  for (size_t i = 1; i < pContext->batchCount; i++)
+    job_run(job_create(parallel_for_batch, pUserData, i, pContext->pRoot));
+
+  parallel_for_batch(pUserData, 0);
+}
+
+void parallel_for(const size_t count, const size_t batchSize, void (*func)(void *pUserData, const size_t begin, const size_t end), void *pUserData)
+{
+  if (count == 0)
+    return;
+
+  const size_t batch = lsMax(lsMax(batchSize, (size_t)1), (count + MaxParallelForBatches - 1) / MaxParallelForBatches);
+  const size_t batchCount = (count + batch - 1) / batch;
+
+  if (batchCount == 1 || _JobSystem.workerCount == 0)
+  {
+    func(pUserData, 0, count);
+    return;
+  }
+
+  parallel_for_context context;
+  context.func = func;
+  context.pUserData = pUserData;
+  context.count = count;
+  context.batchSize = batch;
+  context.batchCount = batchCount;
+  context.pRoot = job_create(parallel_for_split, &context);
+
+  job_run(context.pRoot);
+  job_wait(context.pRoot);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+DEFINE_TESTABLE(job_system_parallel_for)
+{
+  lsResult result = lsR_Success;
+
+  const bool initialized = job_system_workerCount() == 0 && LS_SUCCESS(job_system_init(3));
+
+  {
+    constexpr size_t Count = 10000;
+    std::atomic<size_t> visited[Count];
+
+    for (size_t i = 0; i < Count; i++)
+      visited[i] = 0;
+
+    parallel_for(Count, 64, [&](const size_t begin, const size_t end)
+      {
+        for (size_t i = begin; i < end; i++)
+          visited[i]++;
+      });
+
+    for (size_t i = 0; i < Count; i++)
+      TESTABLE_ASSERT_EQUAL(visited[i].load(), 1);
+  }
+
+  {
+    pool<size_t> p;
+
+    for (size_t i = 0; i < 1000; i++)
+      if (i % 3 != 0)
+        TESTABLE_ASSERT_SUCCESS(pool_insertAt(&p, i, i));
+
+    std::atomic<size_t> sum = 0;
+
+    parallel_for(p, 2, [&](size_t *pItem, const size_t index)
+      {
+        if (*pItem == index)
+          sum += index;
+      });
+
+    size_t expected = 0;
+
+    for (size_t i = 0; i < 1000; i++)
+      if (i % 3 != 0)
+        expected += i;
+
+    TESTABLE_ASSERT_EQUAL(sum.load(), expected);
+  }
+
+epilogue:
+  if (initialized)
+    job_system_destroy();
+
+  return result;
+}
+
+DEFINE_TESTABLE(job_system_continuations)
+{
+  lsResult result = lsR_Success;
+
+  const bool initialized = job_system_workerCount() == 0 && LS_SUCCESS(job_system_init(3));
+
+  {
+    struct ordered_step
+    {
+      std::atomic<size_t> *pCounter;
+      size_t before; // Counter value when the step ran.
+    };
+
+    std::atomic<size_t> counter = 0;
+    ordered_step steps[3] = { { &counter }, { &counter }, { &counter } };
+
+    const job_func step = [](void *pUserData, const size_t)
+    {
+      ordered_step *pStep = reinterpret_cast<ordered_step *>(pUserData);
+      pStep->before = pStep->pCounter->fetch_add(1);
+    };
+
+    // steps[0] and steps[1] run in any order, steps[2] only once both finished.
+    job *pFirst = job_create(step, &steps[0]);
+    job *pSecond = job_create(step, &steps[1]);
+    job *pLast = job_create(step, &steps[2]);
+
+    TESTABLE_ASSERT_SUCCESS(job_addContinuation(pFirst, pLast));
+    TESTABLE_ASSERT_SUCCESS(job_addContinuation(pSecond, pLast));
+
+    job_run(pFirst);
+    job_run(pSecond);
+    job_wait(pLast);
+
+    TESTABLE_ASSERT_EQUAL(steps[2].before, 2);
+    TESTABLE_ASSERT_TRUE(steps[0].before < 2 && steps[1].before < 2);
+  }
+
+  {
+    std::atomic<size_t> children = 0;
+
+    job *pParent = job_create([](void *, const size_t) {});
+
+    for (size_t i = 0; i < 100; i++)
+      job_run(job_create([](void *pUserData, const size_t) { (*reinterpret_cast<std::atomic<size_t> *>(pUserData))++; }, &children, i, pParent));
+
+    job_run(pParent);
+    job_wait(pParent);
+
+    TESTABLE_ASSERT_EQUAL(children.load(), 100);
+  }
+
+  {
+    std::atomic<size_t> children = 0;
+
+    // More jobs than there are slots, while the parent is kept in flight the whole time.
+    job *pParent = job_create([](void *, const size_t) {});
+
+    for (size_t i = 0; i < JobCapacity * 2; i++)
+      job_run(job_create([](void *pUserData, const size_t) { (*reinterpret_cast<std::atomic<size_t> *>(pUserData))++; }, &children, i, pParent));
+
+    job_run(pParent);
+    job_wait(pParent);
+
+    TESTABLE_ASSERT_EQUAL(children.load(), JobCapacity * 2);
+  }
+
+epilogue:
+  if (initialized)
+    job_system_destroy();
+
+  return result;
+}
@@ -0,0 +1,216 @@
+#include "platform_shim.h"
+
+#ifndef _WIN32
+
+//////////////////////////////////////////////////////////////////////////
+
+static thread_local DWORD _LastError = 0;
+
+DWORD GetLastError()
+{
+  return _LastError;
+}
+
+int32_t MultiByteToWideChar(const uint32_t codePage, const DWORD flags, const char *string, const int32_t bytes, wchar_t *pWideString, const int32_t wideCapacity)
+{
+  (void)flags; // Invalid characters always fail.
+
+  if (codePage != CP_UTF8 || string == nullptr || bytes == 0 || wideCapacity < 0 || (wideCapacity > 0 && pWideString == nullptr))
+  {
+    _LastError = ERROR_INVALID_PARAMETER;
+    return 0;
+  }
+
+  const size_t size = bytes < 0 ? strlen(string) + 1 : (size_t)bytes;
+  int32_t count = 0;
+
+  for (size_t i = 0; i < size;)
+  {
+    const uint8_t first = (uint8_t)string[i];
+    size_t charSize;
+    uint32_t codePoint;
+
+    if (first < 0x80)
+    {
+      charSize = 1;
+      codePoint = first;
+    }
+    else if ((first & 0xE0) == 0xC0)
+    {
+      charSize = 2;
+      codePoint = first & 0x1F;
+    }
+    else if ((first & 0xF0) == 0xE0)
+    {
+      charSize = 3;
+      codePoint = first & 0x0F;
+    }
+    else if ((first & 0xF8) == 0xF0)
+    {
+      charSize = 4;
+      codePoint = first & 0x07;
+    }
+    else
+    {
+      _LastError = ERROR_NO_UNICODE_TRANSLATION;
+      return 0;
+    }
+
+    if (i + charSize > size)
+    {
+      _LastError = ERROR_NO_UNICODE_TRANSLATION;
+      return 0;
+    }
+
+    for (size_t j = 1; j < charSize; j++)
+    {
+      const uint8_t next = (uint8_t)string[i + j];
+
+      if ((next & 0xC0) != 0x80)
+      {
+        _LastError = ERROR_NO_UNICODE_TRANSLATION;
+        return 0;
+      }
+
+      codePoint = (codePoint << 6) | (next & 0x3F);
+    }
+
+    constexpr uint32_t MinCodePoint[] = { 0, 0, 0x80, 0x800, 0x10000 };
+
+    if (codePoint < MinCodePoint[charSize] || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) // Overlong encodings and surrogates.
+    {
+      _LastError = ERROR_NO_UNICODE_TRANSLATION;
+      return 0;
+    }
+
+    if (wideCapacity > 0)
+    {
+      if (count == wideCapacity)
+      {
+        _LastError = ERROR_INSUFFICIENT_BUFFER;
+        return 0;
+      }
+
+      pWideString[count] = (wchar_t)codePoint;
+    }
+
+    count++;
+    i += charSize;
+  }
+
+  return count;
+}
+
+int32_t WideCharToMultiByte(const uint32_t codePage, const DWORD flags, const wchar_t *wideString, const int32_t wideCount, char *pString, const int32_t capacity, const char *defaultChar, BOOL *pUsedDefaultChar)
+{
+  (void)flags;
+  (void)defaultChar; // Not supported with `CP_UTF8`, just like on Windows.
+
+  if (codePage != CP_UTF8 || wideString == nullptr || wideCount == 0 || capacity < 0 || (capacity > 0 && pString == nullptr))
+  {
+    _LastError = ERROR_INVALID_PARAMETER;
+    return 0;
+  }
+
+  if (pUsedDefaultChar != nullptr)
+    *pUsedDefaultChar = FALSE;
+
+  const size_t count = wideCount < 0 ? wcslen(wideString) + 1 : (size_t)wideCount;
+  int32_t bytes = 0;
+
+  for (size_t i = 0; i < count; i++)
+  {
+    uint32_t codePoint = (uint32_t)wideString[i];
+
+    if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+      codePoint = 0xFFFD; // Replacement character, like Windows does for invalid characters.
+
+    char encoded[4];
+    int32_t charSize;
+
+    if (codePoint < 0x80)
+    {
+      encoded[0] = (char)codePoint;
+      charSize = 1;
+    }
+    else if (codePoint < 0x800)
+    {
+      encoded[0] = (char)(0xC0 | (codePoint >> 6));
+      encoded[1] = (char)(0x80 | (codePoint & 0x3F));
+      charSize = 2;
+    }
+    else if (codePoint < 0x10000)
+    {
+      encoded[0] = (char)(0xE0 | (codePoint >> 12));
+      encoded[1] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+      encoded[2] = (char)(0x80 | (codePoint & 0x3F));
+      charSize = 3;
+    }
+    else
+    {
+      encoded[0] = (char)(0xF0 | (codePoint >> 18));
+      encoded[1] = (char)(0x80 | ((codePoint >> 12) & 0x3F));
+      encoded[2] = (char)(0x80 | ((codePoint >> 6) & 0x3F));
+      encoded[3] = (char)(0x80 | (codePoint & 0x3F));
+      charSize = 4;
+    }
+
+    if (capacity > 0)
+    {
+      if (bytes + charSize > capacity)
+      {
+        _LastError = ERROR_INSUFFICIENT_BUFFER;
+        return 0;
+      }
+
+      memcpy(pString + bytes, encoded, (size_t)charSize);
+    }
+
+    bytes += charSize;
+  }
+
+  return bytes;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+char *_ui64toa(uint64_t value, char *buffer, const int radix)
+{
+  constexpr char Digits[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+  if (radix < 2 || radix > 36)
+  {
+    buffer[0] = '\0';
+    return buffer;
+  }
+
+  char reversed[64];
+  size_t count = 0;
+
+  do
+  {
+    reversed[count++] = Digits[value % (uint64_t)radix];
+    value /= (uint64_t)radix;
+  } while (value != 0);
+
+  for (size_t i = 0; i < count; i++)
+    buffer[i] = reversed[count - 1 - i];
+
+  buffer[count] = '\0';
+
+  return buffer;
+}
+
+char *_i64toa(const int64_t value, char *buffer, const int radix)
+{
+  if (value < 0 && radix == 10)
+  {
+    buffer[0] = '-';
+    _ui64toa(0 - (uint64_t)value, buffer + 1, radix);
+    return buffer;
+  }
+
+  return _ui64toa((uint64_t)value, buffer, radix);
+}
+
+#endif
@@ -3337,6 +3337,7 @@ void utf8_init(utf8_iter *iter, const char *ptr) {
     iter->codepoint = 0;
     iter->position = 0;
     iter->next = 0;
+    iter->size = 0;
     iter->count = 0;
     iter->length = ptr == nullptr ? 0 : strlen(ptr);
   }
@@ -3348,6 +3349,7 @@ void utf8_initEx(utf8_iter *iter, const char *ptr, size_t length) {
     iter->codepoint = 0;
     iter->position = 0;
     iter->next = 0;
+    iter->size = 0;
     iter->count = 0;
     iter->length = length;
   }
@@ -3600,6 +3602,8 @@ const char *unicode_converter(uint32_t codepoint, uint8_t size) {
 
 #ifdef _WIN32
 #include <Windows.h>
+#else
+#include "platform_shim.h"
 #endif
 
 //////////////////////////////////////////////////////////////////////////
@@ -3696,6 +3700,7 @@ public:
   {
     new (&sformat_GlobalState) sformatState();
 
+#ifdef _WIN32 // Other platforms keep the defaults.
     wchar_t wbuffer[128];
     int32_t size = 0;
 
@@ -3733,6 +3738,7 @@ public:
     sformat_GlobalState.nanBytes = WideCharToMultiByte(CP_UTF8, 0, wbuffer, size, sformat_GlobalState.nanChars, (int32_t)std::size(sformat_GlobalState.nanChars), nullptr, &bFalse);
     sformat_GlobalState.nanCount = _sformat_GetStringCount(sformat_GlobalState.nanChars, sformat_GlobalState.nanBytes);
     sformat_GlobalState.nanBytes -= (size_t)!!sformat_GlobalState.nanBytes;
+#endif
   }
 
 } _sformat_SetLocale;
@@ -0,0 +1,89 @@
+ProjectName = "headless"
+project(ProjectName)
+
+dependson { "gamelib" }
+
+  --Settings
+  kind "ConsoleApp"
+  language "C++"
+  flags { "FatalWarnings" }
+  staticruntime "On"
+
+  cppdialect "C++20"
+
+  filter {"system:windows"}
+    buildoptions { '/MP' }
+    ignoredefaultlibraries { "msvcrt" }
+  
+  filter { }
+  
+  defines { "_CRT_SECURE_NO_WARNINGS", "SSE2" }
+  
+  objdir "intermediate/obj"
+
+  files { "src/**.c", "src/**.cc", "src/**.cpp", "src/**.cxx", "src/**.h", "src/**.hh", "src/**.hpp", "src/**.inl", "src/**rc" }
+
+  files { "project.lua" }
+  
+  includedirs { "src**" }
+  includedirs { "../gamelib/include/" }
+  
+  targetname(ProjectName)
+  targetdir "../builds/bin"
+  debugdir "../builds/bin"
+  
+filter {}
+
+filter {"system:windows", "configurations:Release"}
+  links { "../builds/lib/gamelib.lib" }
+filter {"system:windows", "configurations:Debug"}
+  links { "../builds/lib/gamelibD.lib" }
+
+filter {"system:not windows"}
+  libdirs { "../builds/lib" }
+  links { "pthread" }
+filter {"system:not windows", "configurations:Release"}
+  links { "gamelib" }
+filter {"system:not windows", "configurations:Debug"}
+  links { "gamelibD" }
+
+filter {}
+warnings "Extra"
+
+filter {"configurations:Release"}
+  targetname "%{prj.name}"
+filter {"configurations:Debug"}
+  targetname "%{prj.name}D"
+
+filter { }
+  exceptionhandling "Off"
+  rtti "Off"
+  floatingpoint "Fast"
+
+filter { "configurations:Debug*" }
+	defines { "_DEBUG" }
+	optimize "Off"
+	symbols "FastLink"
+
+filter { "configurations:Release*" }
+	defines { "NDEBUG" }
+	optimize "Speed"
+	flags { "NoBufferSecurityCheck" }
+  omitframepointer "On"
+  symbols "On"
+
+filter { "system:windows" }
+	defines { "WIN32", "_WINDOWS" }
+  flags { "NoPCH", "NoMinimalRebuild" }
+  links { "kernel32.lib", "user32.lib", "advapi32.lib", "Ws2_32.lib" }
+
+filter { "system:windows", "configurations:Release" }
+  flags { "NoIncrementalLink" }
+
+filter { "system:windows", "configurations:Debug" }
+  ignoredefaultlibraries { "libcmt" }
+
+filter { "system:not windows" }
+  buildoptions { "-msse4.1", "-maes" }
+  disablewarnings { "unknown-pragmas", "sign-compare", "switch", "type-limits", "class-memaccess", "nonnull-compare", "missing-field-initializers" }
+filter { }
@@ -0,0 +1,273 @@
+#include "game.h"
+#include "job_system.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <thread>
+
+//////////////////////////////////////////////////////////////////////////
+
+// Runs the simulation without a window or renderer at maximum speed, e.g. for benchmarks and soak tests.
+// Usage: headless [--ticks <count>] [--size <width>x<height>] [--seed <seed>] [--actors <lumberjacks>,<farmers>,<cooks>,<fire actors>] [--job-benchmark <iterations>] [--tile-layout <row-major|chunked|compare>]
+// `--tile-layout compare` times complete fills of every target on a 2048x2048 map in both direction map layouts instead of simulating.
+
+lsResult ParseArguments(const int32_t argc, const char **pArgs, _Out_ size_t *pTickCount, _Out_ level_settings *pSettings, _Out_ size_t *pJobBenchmarkIterations, _Out_ tile_storage_layout *pTileLayout, _Out_ bool *pCompareTileLayouts);
+lsResult RunSimulation(const size_t tickCount, const level_settings &settings, const tile_storage_layout tileLayout);
+lsResult RunJobBenchmark(const size_t iterations);
+lsResult RunTileLayoutBenchmark(const uint64_t seed);
+
+//////////////////////////////////////////////////////////////////////////
+
+int32_t main(int32_t argc, char **pArgv)
+{
+  size_t tickCount;
+  level_settings settings;
+  size_t jobBenchmarkIterations;
+  tile_storage_layout tileLayout;
+  bool compareTileLayouts;
+
+  if (LS_FAILED(ParseArguments(argc, const_cast<const char **>(pArgv), &tickCount, &settings, &jobBenchmarkIterations, &tileLayout, &compareTileLayouts)))
+  {
+    printf("Usage: %s [--ticks <count>] [--size <width>x<height>] [--seed <seed>] [--actors <lumberjacks>,<farmers>,<cooks>,<fire actors>] [--job-benchmark <iterations>] [--tile-layout <row-major|chunked|compare>]\n", pArgv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (jobBenchmarkIterations)
+    return LS_SUCCESS(RunJobBenchmark(jobBenchmarkIterations)) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+  if (compareTileLayouts)
+    return LS_SUCCESS(RunTileLayoutBenchmark(settings.seed)) ? EXIT_SUCCESS : EXIT_FAILURE;
+
+  return LS_SUCCESS(RunSimulation(tickCount, settings, tileLayout)) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+lsResult ParseArguments(const int32_t argc, const char **pArgs, _Out_ size_t *pTickCount, _Out_ level_settings *pSettings, _Out_ size_t *pJobBenchmarkIterations, _Out_ tile_storage_layout *pTileLayout, _Out_ bool *pCompareTileLayouts)
+{
+  lsResult result = lsR_Success;
+
+  *pTickCount = 10000;
+  *pSettings = level_settings();
+  *pJobBenchmarkIterations = 0;
+  *pTileLayout = tSL_rowMajor;
+  *pCompareTileLayouts = false;
+
+  for (int32_t i = 1; i < argc; i++)
+  {
+    LS_ERROR_IF(i + 1 >= argc, lsR_InvalidParameter); // Every option takes a value.
+
+    const char *option = pArgs[i];
+    const char *value = pArgs[++i];
+
+    if (strcmp(option, "--ticks") == 0)
+    {
+      unsigned long long ticks;
+      LS_ERROR_IF(sscanf(value, "%llu", &ticks) != 1, lsR_InvalidParameter);
+      *pTickCount = (size_t)ticks;
+    }
+    else if (strcmp(option, "--size") == 0)
+    {
+      unsigned long long width, height;
+      LS_ERROR_IF(sscanf(value, "%llux%llu", &width, &height) != 2, lsR_InvalidParameter);
+      pSettings->mapSize = vec2s((size_t)width, (size_t)height);
+    }
+    else if (strcmp(option, "--seed") == 0)
+    {
+      unsigned long long seed;
+      LS_ERROR_IF(sscanf(value, "%llu", &seed) != 1, lsR_InvalidParameter);
+      pSettings->seed = (uint64_t)seed;
+    }
+    else if (strcmp(option, "--actors") == 0)
+    {
+      static_assert(aT_count == 4, "Update the actor mix parsing.");
+
+      unsigned long long counts[aT_count];
+      LS_ERROR_IF(sscanf(value, "%llu,%llu,%llu,%llu", &counts[aT_lumberjack], &counts[aT_farmer], &counts[aT_cook], &counts[aT_fire_actor]) != aT_count, lsR_InvalidParameter);
+
+      for (size_t j = 0; j < aT_count; j++)
+        pSettings->actorCounts[j] = (size_t)counts[j];
+    }
+    else if (strcmp(option, "--job-benchmark") == 0)
+    {
+      unsigned long long iterations;
+      LS_ERROR_IF(sscanf(value, "%llu", &iterations) != 1 || iterations == 0, lsR_InvalidParameter);
+      *pJobBenchmarkIterations = (size_t)iterations;
+    }
+    else if (strcmp(option, "--tile-layout") == 0)
+    {
+      if (strcmp(value, "row-major") == 0)
+        *pTileLayout = tSL_rowMajor;
+      else if (strcmp(value, "chunked") == 0)
+        *pTileLayout = tSL_chunked;
+      else if (strcmp(value, "compare") == 0)
+        *pCompareTileLayouts = true;
+      else
+        LS_ERROR_SET(lsR_InvalidParameter);
+    }
+    else
+    {
+      LS_ERROR_SET(lsR_InvalidParameter);
+    }
+  }
+
+epilogue:
+  return result;
+}
+
+static const char *TileLayoutNames[] = { "row major", "chunked" };
+
+lsResult RunSimulation(const size_t tickCount, const level_settings &settings, const tile_storage_layout tileLayout)
+{
+  lsResult result = lsR_Success;
+
+  const char *SystemNames[] = { "day night cycle", "pathfinding", "movement", "lifesupport", "actions" };
+  static_assert(LS_ARRAYSIZE(SystemNames) == gS_count);
+
+  printf("Simulating %llu ticks on a %llux%llu map (seed %llu, actors %llu/%llu/%llu/%llu, %s direction maps).\n", (unsigned long long)tickCount, (unsigned long long)settings.mapSize.x, (unsigned long long)settings.mapSize.y, (unsigned long long)settings.seed,
+    (unsigned long long)settings.actorCounts[aT_lumberjack], (unsigned long long)settings.actorCounts[aT_farmer], (unsigned long long)settings.actorCounts[aT_cook], (unsigned long long)settings.actorCounts[aT_fire_actor], TileLayoutNames[tileLayout]);
+
+  {
+    const int64_t beforeInit = lsGetCurrentTimeNs();
+    LS_ERROR_CHECK(game_init(settings));
+    game_setTileStorageLayout(tileLayout);
+    const int64_t beforeTicks = lsGetCurrentTimeNs();
+
+    for (size_t i = 0; i < tickCount; i++)
+      LS_ERROR_CHECK(game_tick());
+
+    const int64_t afterTicks = lsGetCurrentTimeNs();
+    const double tickSeconds = (double)(afterTicks - beforeTicks) * 1e-9;
+    const game *pGame = game_getGame();
+
+    printf("Init: %.3f ms\n", (double)(beforeTicks - beforeInit) * 1e-6);
+    printf("Ticks: %.3f s, %.1f ticks/s, %.4f ms/tick\n", tickSeconds, (double)tickCount / lsMax(tickSeconds, 1e-9), tickSeconds * 1e3 / (double)lsMax(tickCount, (size_t)1));
+
+    for (size_t i = 0; i < gS_count; i++)
+      printf("  %-16s %10.3f ms total, %.4f ms/tick\n", SystemNames[i], (double)pGame->systemTimeNs[i] * 1e-6, (double)pGame->systemTimeNs[i] * 1e-6 / (double)lsMax(tickCount, (size_t)1));
+  }
+
+epilogue:
+  if (LS_FAILED(result))
+    printf("Simulation failed with error code %d.\n", (int32_t)result);
+
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// Compares `parallel_for` against spawning a `std::thread` per hardware thread for every dispatch, on a workload of roughly tick size.
+lsResult RunJobBenchmark(const size_t iterations)
+{
+  lsResult result = lsR_Success;
+
+  constexpr size_t ValueCount = 1 << 18;
+  float_t *pValues = nullptr;
+
+  LS_ERROR_CHECK(lsAllocZero(&pValues, ValueCount));
+  LS_ERROR_CHECK(job_system_init());
+
+  {
+    const size_t threadCount = lsMax((size_t)std::thread::hardware_concurrency(), (size_t)1);
+
+    const auto work = [=](const size_t begin, const size_t end)
+    {
+      for (size_t i = begin; i < end; i++)
+        pValues[i] = sqrtf(pValues[i] + (float_t)i);
+    };
+
+    printf("Dispatching %llu values %llu times on %llu job workers / %llu threads.\n", (unsigned long long)ValueCount, (unsigned long long)iterations, (unsigned long long)job_system_workerCount(), (unsigned long long)threadCount);
+
+    const int64_t beforeSerial = lsGetCurrentTimeNs();
+
+    for (size_t i = 0; i < iterations; i++)
+      work(0, ValueCount);
+
+    const int64_t beforeJobs = lsGetCurrentTimeNs();
+
+    for (size_t i = 0; i < iterations; i++)
+      parallel_for(ValueCount, 1024, work);
+
+    const int64_t beforeThreads = lsGetCurrentTimeNs();
+
+    for (size_t i = 0; i < iterations; i++)
+    {
+      std::thread threads[64];
+      const size_t count = lsMin(threadCount, LS_ARRAYSIZE(threads));
+      const size_t perThread = (ValueCount + count - 1) / count;
+
+      for (size_t j = 0; j < count; j++)
+        threads[j] = std::thread(work, lsMin(j * perThread, ValueCount), lsMin((j + 1) * perThread, ValueCount));
+
+      for (size_t j = 0; j < count; j++)
+        threads[j].join();
+    }
+
+    const int64_t afterThreads = lsGetCurrentTimeNs();
+
+    printf("  %-16s %.4f ms/dispatch\n", "serial", (double)(beforeJobs - beforeSerial) * 1e-6 / (double)iterations);
+    printf("  %-16s %.4f ms/dispatch\n", "parallel_for", (double)(beforeThreads - beforeJobs) * 1e-6 / (double)iterations);
+    printf("  %-16s %.4f ms/dispatch\n", "std::thread", (double)(afterThreads - beforeThreads) * 1e-6 / (double)iterations);
+  }
+
+epilogue:
+  job_system_destroy();
+  lsFreePtr(&pValues);
+
+  if (LS_FAILED(result))
+    printf("Job benchmark failed with error code %d.\n", (int32_t)result);
+
+  return result;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+// Refills the direction maps of all targets with the queue engine in both layouts. Cache misses aren't counted here, run it under a profiler (e.g. `perf stat -e cache-misses`) per layout for those.
+lsResult RunTileLayoutBenchmark(const uint64_t seed)
+{
+  lsResult result = lsR_Success;
+
+  constexpr size_t Iterations = 3;
+  static_assert(LS_ARRAYSIZE(TileLayoutNames) == tSL_chunked + 1);
+
+  level_settings settings;
+  settings.mapSize = vec2s(2048, 2048);
+  settings.seed = seed;
+
+  LS_ERROR_CHECK(game_init(settings));
+  game_setPathfindingLayout(pL_flat); // Hierarchical targets only fill the clusters that were queried.
+
+  {
+    const size_t tileCount = settings.mapSize.x * settings.mapSize.y;
+    const size_t targetCount = ptT_Count - 1; // Skip ptT_collidable
+
+    printf("Filling %llu targets on a %llux%llu map %llu times per layout (seed %llu).\n", (unsigned long long)targetCount, (unsigned long long)settings.mapSize.x, (unsigned long long)settings.mapSize.y, (unsigned long long)Iterations, (unsigned long long)seed);
+
+    for (size_t layout = 0; layout < LS_ARRAYSIZE(TileLayoutNames); layout++)
+    {
+      game_setTileStorageLayout((tile_storage_layout)layout);
+
+      for (size_t target = 0; target < targetCount; target++) // Allocates the maps, so the timed fills only touch memory.
+        LS_ERROR_CHECK(game_fillDirectionMap((pathfinding_target_type)target));
+
+      const int64_t before = lsGetCurrentTimeNs();
+
+      for (size_t i = 0; i < Iterations; i++)
+        for (size_t target = 0; target < targetCount; target++)
+          LS_ERROR_CHECK(game_fillDirectionMap((pathfinding_target_type)target));
+
+      const double seconds = (double)(lsGetCurrentTimeNs() - before) * 1e-9;
+
+      printf("  %-16s %10.3f ms/fill, %.1f Mtiles/s\n", TileLayoutNames[layout], seconds * 1e3 / (double)(Iterations * targetCount), (double)(Iterations * targetCount * tileCount) * 1e-6 / lsMax(seconds, 1e-9));
+    }
+  }
+
+epilogue:
+  if (LS_FAILED(result))
+    printf("Tile layout benchmark failed with error code %d.\n", (int32_t)result);
+
+  return result;
+}
@@ -6,3 +6,4 @@ solution "flooderful"
 
   dofile "flooderful/project.lua"
   dofile "gamelib/project.lua"
+  dofile "headless/project.lua"